@@ -1,8 +1,25 @@
 #include "Application.h"
+#include "classes/Autosave.hpp"
+#include "classes/FrameScheduler.hpp"
+#include "classes/GameArchive.hpp"
+#include "classes/GameSettings.hpp"
+#include "classes/GpuTexture.hpp"
 #include "classes/Logger.hpp"
+#include "classes/Profiler.hpp"
+#include "classes/SpriteBatch.hpp"
+#include "classes/TextureAtlas.hpp"
+#include "classes/TextureLoader.hpp"
 #include "classes/TicTacToe.h"
+#include "classes/Tracer.hpp"
 #include "imgui/imgui.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
 // In addition to the implementation in TicTacToe.cpp, I have also added in my logger class from the previous assignment (with the UI bundled into the class), and adjusted the buildscript/main_macos to theoretically work on linux (though my linux installation is broken so I couldn't test it and can only confirm that this works on windows).
 
 namespace ClassGame {
@@ -13,6 +30,114 @@ namespace ClassGame {
     bool       gameOver   = false;
     int        gameWinner = -1;
 
+    // the state string shown in the settings window, rebuilt only when the game's state version changes
+    std::string  stateDisplay;
+    unsigned int stateDisplayVersion = 0;
+    bool         stateDisplayValid   = false;
+
+    // set TICTACTOE_TRACE=<file> to trace the whole session and write it on exit
+    const char* traceOnExitPath = nullptr;
+
+    // hooks the game's events up to the functions below
+    struct Listener : GameListener {
+        void turnEnded(Game&) override {
+            EndOfTurn();
+            // the next player (possibly the AI) needs a frame even if nobody touches the mouse
+            FrameScheduler::GetInstance().RequestFrame();
+        }
+        void gameWon(Game&, Player& winner) override { EndOfGame(winner.playerNumber()); }
+        void gameDrawn(Game&) override { EndOfGame(-1); }
+    };
+    Listener listener;
+
+    // cold start is measured from static initialization to the first call to RenderGame()
+    const auto processStart   = std::chrono::steady_clock::now();
+    bool       firstFrameDone = false;
+
+    //
+    // multi-board mode: AI vs AI games drawn as tiles of the Boards window, next to the game being played.
+    // they have no listeners, so they're never autosaved or archived
+    //
+    struct Board {
+        std::unique_ptr<TicTacToe> game;
+        FrameScheduler::Clock::time_point nextMove; // moves are paced so the games can be followed
+    };
+    std::vector<Board> boards;
+
+    ImGuiID boardsDockId = 0; // the dock space the Boards window starts in
+
+    constexpr int   MAX_BOARDS      = 144;
+    constexpr float TILE_GAP        = 2.0f;
+    constexpr auto  MOVE_INTERVAL   = std::chrono::milliseconds(400);
+    constexpr auto  GAME_OVER_PAUSE = std::chrono::milliseconds(1500);
+    // perfect play always draws: a shallow search with a few random moves makes the games worth watching, and is cheap
+    // enough that a wall of boards never keeps the AI of the game being played waiting long on the shared workers. Their
+    // searches aren't logged, a wall of boards would bury the game being played under thousands of lines a second
+    const AIConfig boardAI{"exhibition", 4, 0.15, false};
+
+    void SetBoardCount(int count) {
+        count = std::clamp(count, 0, MAX_BOARDS);
+        while (static_cast<int>(boards.size()) > count) {
+            boards.pop_back();
+        }
+        while (static_cast<int>(boards.size()) < count) {
+            Board board;
+            board.game = std::make_unique<TicTacToe>();
+            board.game->setAIvsAI(true);
+            board.game->setAIConfig(boardAI, static_cast<unsigned int>(boards.size()) + 1);
+            board.game->setUpBoard();
+            boards.push_back(std::move(board));
+        }
+    }
+
+    //
+    // play and draw every board: the boards share the AI's worker threads and, through the texture atlas, one texture,
+    // so the whole window is a single draw command
+    //
+    void RenderBoards() {
+        if (boards.empty())
+            return;
+        PROFILE_ZONE("ClassGame::RenderBoards");
+
+        const auto now     = FrameScheduler::Clock::now();
+        const int  count   = static_cast<int>(boards.size());
+        const int  columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+        const int  rows    = (count + columns - 1) / columns;
+
+        ImGui::SetNextWindowDockID(boardsDockId, ImGuiCond_FirstUseEver);
+        ImGui::Begin("Boards");
+        const ImVec2 area   = ImGui::GetContentRegionAvail();
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const ImVec2 tile(area.x / columns, area.y / rows);
+        for (int i = 0; i < count; i++) {
+            Board&     board     = boards[i];
+            TicTacToe& boardGame = *board.game;
+            if (now >= board.nextMove) {
+                if (boardGame.gameOver()) {
+                    boardGame.stopGame();
+                    boardGame.setUpBoard();
+                    board.nextMove = now + MOVE_INTERVAL;
+                }
+                else {
+                    const unsigned int turnNo = boardGame.getCurrentTurnNo();
+                    boardGame.updateAI();
+                    if (boardGame.getCurrentTurnNo() != turnNo) {
+                        board.nextMove = now + (boardGame.gameOver() ? GAME_OVER_PAUSE : MOVE_INTERVAL);
+                    }
+                }
+            }
+            if (tile.x > 2 * TILE_GAP && tile.y > 2 * TILE_GAP) {
+                const ImVec2 min(origin.x + tile.x * static_cast<float>(i % columns) + TILE_GAP,
+                                 origin.y + tile.y * static_cast<float>(i / columns) + TILE_GAP);
+                boardGame.drawTile(min, ImVec2(tile.x - 2 * TILE_GAP, tile.y - 2 * TILE_GAP));
+            }
+        }
+        ImGui::End();
+
+        // the boards keep moving without any input
+        FrameScheduler::GetInstance().RequestFrame();
+    }
+
     //
     // game starting point
     // this is called by the main render loop in main.cpp
@@ -22,8 +147,82 @@ namespace ClassGame {
         io.Fonts->AddFontFromFileTTF("resources/Noto_Sans/NotoSans-Regular.ttf",
                                      20.0f);
 
+        Tracer::GetInstance().SetThreadName("main");
+        traceOnExitPath = std::getenv("TICTACTOE_TRACE");
+        if (traceOnExitPath) {
+            Tracer::GetInstance().Start();
+        }
+
+        // set TICTACTOE_ARCHIVE=<file> to append every finished game to a game archive
+        if (const char* archivePath = std::getenv("TICTACTOE_ARCHIVE")) {
+            if (!GameArchive::GetInstance().Open(archivePath)) {
+                Logger::GetInstance().LogError("Could not open the game archive {}", archivePath);
+            }
+        }
+
+        // pack every sprite image into one texture before anything loads its sprite
+        TextureAtlas::GetInstance().Build("resources");
+
         game = new TicTacToe();
+        game->addListener(&listener);
         game->setUpBoard();
+
+        // set TICTACTOE_AUTOSAVE=<file> to journal every turn and pick the game up again on the next start
+        if (const char* autosavePath = std::getenv("TICTACTOE_AUTOSAVE")) {
+            Autosave&     autosave = Autosave::GetInstance();
+            MoveLog       saved;
+            std::uint32_t savedTurn = 0;
+            const auto    start     = std::chrono::steady_clock::now();
+            if (autosave.Load(autosavePath, saved, savedTurn) && game->restoreGame(saved, savedTurn)) {
+                RefreshGameOver();
+                const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+                Logger::GetInstance().LogInfo("Restored the autosaved game at turn {} ({:.0f} us)", savedTurn, us);
+            }
+            if (autosave.Open(autosavePath)) {
+                autosave.Snapshot(game->moveLog(), game->getCurrentTurnNo());
+            }
+            else {
+                Logger::GetInstance().LogError("Could not open the autosave journal for {}", autosavePath);
+            }
+        }
+
+        // the game and its AI setting go into imgui.ini, read back on the first frame
+        GameSettings::GetInstance().Register();
+
+        // set TICTACTOE_BOARDS=<n> to start with n AI vs AI boards
+        if (const char* boardCount = std::getenv("TICTACTOE_BOARDS")) {
+            SetBoardCount(std::atoi(boardCount));
+        }
+    }
+
+    //
+    // called by main.cpp after the render loop exits, before imgui is shut down
+    //
+    void GameShutDown() {
+        if (traceOnExitPath) {
+            Tracer::GetInstance().Stop();
+            if (Tracer::GetInstance().Flush(traceOnExitPath)) {
+                Logger::GetInstance().LogInfo("Trace written to {}", traceOnExitPath);
+            }
+        }
+
+        // imgui.ini is saved once more when the ImGui context goes, after the game
+        GameSettings::GetInstance().Detach();
+        delete game;
+        game = nullptr;
+        boards.clear();
+
+        // syncs the turns still queued
+        Autosave::GetInstance().Close();
+        // writes whatever games are still queued
+        GameArchive::GetInstance().Close();
+
+        // with the sprites gone every texture should be freed here, anything left over is a leak
+        TextureLoader::GetInstance().Clear();
+        TextureAtlas::GetInstance().Release();
+        if (GpuTexture::LiveCount() != 0) {
+            Logger::GetInstance().LogWarn("{} GPU textures still alive at shutdown", GpuTexture::LiveCount());
+        }
     }
 
     //
@@ -31,7 +230,18 @@ namespace ClassGame {
     // this is called by the main render loop in main.cpp
     //
     void RenderGame() {
-        ImGui::DockSpaceOverViewport();
+        Profiler::GetInstance().NewFrame();
+        TRACE_SCOPE("ClassGame::RenderGame");
+
+        if (!firstFrameDone) {
+            firstFrameDone  = true;
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - processStart).count();
+            Logger::GetInstance().LogInfo("Startup to first frame: {:.1f} ms", ms);
+        }
+
+        TextureLoader::GetInstance().Update();
+
+        boardsDockId = ImGui::DockSpaceOverViewport();
 
         // ImGui::ShowDemoWindow();
 
@@ -40,19 +250,86 @@ namespace ClassGame {
         if (!game->getCurrentPlayer())
             return;
 
+        if (!stateDisplayValid || stateDisplayVersion != game->stateVersion()) {
+            stateDisplay        = game->stateString();
+            stateDisplayVersion = game->stateVersion();
+            stateDisplayValid   = true;
+        }
+
         ImGui::Begin("Settings");
         ImGui::Text("Current Player Number: %d",
                     game->getCurrentPlayer()->playerNumber());
-        ImGui::Text("Current Board State: %s", game->stateString().c_str());
+        ImGui::Text("Current Board State: %s", stateDisplay.c_str());
+
+        FrameScheduler& scheduler   = FrameScheduler::GetInstance();
+        bool            powerSaving = scheduler.PowerSaving();
+        if (ImGui::Checkbox("Power Saving", &powerSaving)) {
+            scheduler.SetPowerSaving(powerSaving);
+        }
+        ImGui::SameLine();
+        ImGui::Text("%.1f fps, %.0f%% idle", scheduler.FramesPerSecond(), scheduler.IdleRatio() * 100.0);
+        ImGui::Text("GPU textures: %d live, %zu cached", GpuTexture::LiveCount(),
+                    TextureLoader::GetInstance().CachedCount());
+        bool retainedDraw = game->retainedDraw();
+        if (ImGui::Checkbox("Retained Board Drawing", &retainedDraw)) {
+            game->setRetainedDraw(retainedDraw);
+        }
+        if (SpriteBatch::Available() || !SpriteBatch::Enabled()) {
+            ImGui::SameLine();
+            bool batched = SpriteBatch::Enabled();
+            if (ImGui::Checkbox("Instanced Sprite Batch", &batched)) {
+                SpriteBatch::SetEnabled(batched);
+            }
+        }
+
+        // turn history: undo/redo skip over the AI's turns so they land on a move the human can make
+        bool seeked = false;
+        ImGui::BeginDisabled(!game->canUndo());
+        if (ImGui::Button("Undo")) {
+            do {
+                game->undoTurn();
+            } while (game->canUndo() && game->getCurrentPlayer()->isAIPlayer());
+            seeked = true;
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        ImGui::BeginDisabled(!game->canRedo());
+        if (ImGui::Button("Redo")) {
+            do {
+                game->redoTurn();
+            } while (game->canRedo() && game->getCurrentPlayer()->isAIPlayer());
+            seeked = true;
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        int turnNo = static_cast<int>(game->getCurrentTurnNo());
+        if (ImGui::SliderInt("Turn", &turnNo, 0, static_cast<int>(game->lastTurnNo()))) {
+            game->seekToTurn(static_cast<unsigned int>(turnNo));
+            seeked = true;
+        }
+        if (seeked) {
+            RefreshGameOver();
+            Autosave::GetInstance().RecordSeek(game->moveLog(), game->getCurrentTurnNo());
+            GameSettings::GetInstance().MarkDirty();
+        }
+        bool aiEnabled = game->aiEnabled();
+        if (ImGui::Checkbox("Play Against AI", &aiEnabled)) {
+            game->setAIEnabled(aiEnabled);
+            // it may be the AI's turn right now
+            FrameScheduler::GetInstance().RequestFrame();
+            GameSettings::GetInstance().MarkDirty();
+        }
+
+        int boardCount = static_cast<int>(boards.size());
+        if (ImGui::SliderInt("AI vs AI Boards", &boardCount, 0, MAX_BOARDS)) {
+            SetBoardCount(boardCount);
+        }
 
         if (gameOver) {
             ImGui::Text("Game Over!");
             ImGui::Text("Winner: %d", gameWinner);
             if (ImGui::Button("Reset Game")) {
-                game->stopGame();
-                game->setUpBoard();
-                gameOver   = false;
-                gameWinner = -1;
+                ResetGame();
             }
         }
         ImGui::End();
@@ -61,24 +338,64 @@ namespace ClassGame {
         game->drawFrame();
         ImGui::End();
 
+        RenderBoards();
+
         Logger::GetInstance().UI();
+        Profiler::GetInstance().UI();
+    }
+
+    Game* CurrentGame() {
+        return game;
+    }
+
+    bool IsGameOver() {
+        return gameOver;
+    }
+
+    //
+    // clear the board and start a new game (the Reset Game button, or the headless frontend between games)
+    //
+    void ResetGame() {
+        game->stopGame();
+        game->setUpBoard();
+        gameOver   = false;
+        gameWinner = -1;
+        Autosave::GetInstance().Snapshot(game->moveLog(), game->getCurrentTurnNo());
+        GameSettings::GetInstance().MarkDirty();
+    }
+
+    //
+    // the result follows the board when moving through the turn history
+    //
+    void RefreshGameOver() {
+        gameOver   = game->gameOver();
+        gameWinner = game->winner() ? game->winner()->playerNumber() : -1;
     }
 
     //
     // end turn is called by the game code at the end of each turn
-    // this is where we check for a winner
     //
     void EndOfTurn() {
-        Player* winner = game->checkForWinner();
-        if (winner) {
-            gameOver   = true;
-            gameWinner = winner->playerNumber();
-            Logger::GetInstance().LogGameEventInfo("Game over. Won by player {}", winner->playerNumber());
-        }
-        if (game->checkForDraw()) {
-            gameOver   = true;
-            gameWinner = -1;
+        TRACE_SCOPE("ClassGame::EndOfTurn");
+
+        Autosave::GetInstance().RecordTurn(game->moveLog(), game->getCurrentTurnNo());
+        GameSettings::GetInstance().MarkDirty();
+    }
+
+    //
+    // end of game follows it when that turn won or drew the game (winner is -1 for a draw)
+    //
+    void EndOfGame(int winner) {
+        gameOver   = true;
+        gameWinner = winner;
+        if (winner >= 0) {
+            Logger::GetInstance().LogGameEventInfo("Game over. Won by player {}", winner);
+        } else {
             Logger::GetInstance().LogGameEventInfo("Game over. Draw.");
         }
+        if (GameArchive::GetInstance().IsOpen()) {
+            const std::uint32_t number = GameArchive::GetInstance().Append(game->gameRecord(gameWinner));
+            Logger::GetInstance().LogGameEventInfo("Game archived as game {}", number);
+        }
     }
 } // namespace ClassGame
@@ -1,7 +1,15 @@
 #pragma once
 
+class Game;
+
 namespace ClassGame {
     void GameStartUp();
+    void GameShutDown();
     void RenderGame();
     void EndOfTurn();
+    void EndOfGame(int winner);
+    bool IsGameOver();
+    void ResetGame();
+    void RefreshGameOver();
+    Game* CurrentGame();
 }
@@ -0,0 +1,249 @@
+#include "classes/AtlasCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "classes/stb_image.h"
+
+// our own static copy of the packer (imgui keeps its copy static too)
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+    constexpr char          MAGIC[8] = {'T', 'T', 'T', 'A', 'T', 'L', 'A', 'S'};
+    constexpr std::uint32_t VERSION  = 1;
+    constexpr std::size_t   NAME_SIZE = 56;
+    constexpr std::size_t   PIXEL_ALIGNMENT = 16;
+
+    struct FileHeader {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t region_count;
+        std::uint64_t fingerprint;
+        std::uint32_t white_x;
+        std::uint32_t white_y;
+        std::uint64_t pixel_offset;
+    };
+
+    struct FileRegion {
+        char          name[NAME_SIZE]; // zero padded
+        std::uint32_t x;
+        std::uint32_t y;
+        std::uint32_t width;
+        std::uint32_t height;
+    };
+
+    std::vector<std::filesystem::path> SourceImages(const std::filesystem::path& directory) {
+        std::vector<std::filesystem::path> files;
+        std::error_code                    error;
+        for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+            if (file.is_regular_file() && file.path().extension() == ".png") files.push_back(file.path());
+        }
+        // directory order isn't stable across platforms, and both the fingerprint and the packing depend on it
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    void HashBytes(std::uint64_t& hash, const char* bytes, const std::size_t size) {
+        // FNV-1a
+        for (std::size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(bytes[i]);
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    std::size_t AlignUp(const std::size_t value, const std::size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+} // namespace
+
+std::uint64_t AtlasCache::Fingerprint(const std::filesystem::path& directory) {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    HashBytes(hash, reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    for (const auto& path : SourceImages(directory)) {
+        const std::string name = path.filename().string();
+        HashBytes(hash, name.c_str(), name.size() + 1);
+
+        std::ifstream     in(path, std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        HashBytes(hash, contents.data(), contents.size());
+    }
+    return hash;
+}
+
+bool AtlasCache::Pack(const std::filesystem::path& directory, PackedAtlas& atlas, std::string& error) {
+    struct Image {
+        std::string    name;
+        int            width  = 0;
+        int            height = 0;
+        unsigned char* pixels = nullptr;
+    };
+
+    std::vector<Image> images;
+    for (const auto& path : SourceImages(directory)) {
+        Image image;
+        image.name = path.filename().string();
+        if (image.name.size() >= NAME_SIZE) {
+            continue; // can't be stored in the cache
+        }
+        image.pixels = stbi_load(path.string().c_str(), &image.width, &image.height, nullptr, 4);
+        if (image.pixels) {
+            images.push_back(image);
+        }
+    }
+    if (images.empty()) {
+        error = "no images found in " + directory.string();
+        return false;
+    }
+
+    // the last rect is the white block
+    std::vector<stbrp_rect> rects(images.size() + 1);
+    for (std::size_t i = 0; i < images.size(); i++) {
+        rects[i].id = static_cast<int>(i);
+        rects[i].w  = images[i].width + PADDING * 2;
+        rects[i].h  = images[i].height + PADDING * 2;
+    }
+    rects.back().id = static_cast<int>(images.size());
+    rects.back().w = rects.back().h = WHITE_BLOCK + PADDING * 2;
+
+    // grow a square atlas until everything fits
+    int  size   = 256;
+    bool packed = false;
+    for (; size <= MAX_SIZE; size *= 2) {
+        std::vector<stbrp_node> nodes(static_cast<std::size_t>(size));
+        stbrp_context           context;
+        stbrp_init_target(&context, size, size, nodes.data(), static_cast<int>(nodes.size()));
+        packed = stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size())) == 1;
+        if (packed) break;
+    }
+    if (!packed) {
+        for (auto& image : images) stbi_image_free(image.pixels);
+        error = "images don't fit in " + std::to_string(MAX_SIZE) + "x" + std::to_string(MAX_SIZE);
+        return false;
+    }
+
+    atlas.width  = static_cast<std::uint32_t>(size);
+    atlas.height = static_cast<std::uint32_t>(size);
+    atlas.regions.clear();
+    atlas.storage.assign(static_cast<std::size_t>(size) * size * 4, 0);
+
+    const auto blit = [&](const int x, const int y, const int w, const int h, const unsigned char* src) {
+        for (int row = 0; row < h; row++) {
+            unsigned char* dst = &atlas.storage[(static_cast<std::size_t>(y + row) * size + x) * 4];
+            if (src) {
+                std::memcpy(dst, src + static_cast<std::size_t>(row) * w * 4, static_cast<std::size_t>(w) * 4);
+            }
+            else {
+                std::memset(dst, 0xFF, static_cast<std::size_t>(w) * 4);
+            }
+        }
+    };
+
+    for (const stbrp_rect& rect : rects) {
+        const int x = rect.x + PADDING;
+        const int y = rect.y + PADDING;
+        if (rect.id == static_cast<int>(images.size())) {
+            blit(x, y, WHITE_BLOCK, WHITE_BLOCK, nullptr);
+            atlas.white_x = static_cast<std::uint32_t>(x);
+            atlas.white_y = static_cast<std::uint32_t>(y);
+            continue;
+        }
+
+        Image& image = images[static_cast<std::size_t>(rect.id)];
+        blit(x, y, image.width, image.height, image.pixels);
+        atlas.regions.push_back(PackedRegion{image.name, static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y),
+                                             static_cast<std::uint32_t>(image.width),
+                                             static_cast<std::uint32_t>(image.height)});
+        stbi_image_free(image.pixels);
+    }
+
+    atlas.pixels = atlas.storage.data();
+    return true;
+}
+
+bool AtlasCache::Write(const std::filesystem::path& path, const PackedAtlas& atlas, const std::uint64_t fingerprint) {
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version      = VERSION;
+    header.width        = atlas.width;
+    header.height       = atlas.height;
+    header.region_count = static_cast<std::uint32_t>(atlas.regions.size());
+    header.fingerprint  = fingerprint;
+    header.white_x      = atlas.white_x;
+    header.white_y      = atlas.white_y;
+    header.pixel_offset = AlignUp(sizeof(FileHeader) + sizeof(FileRegion) * atlas.regions.size(), PIXEL_ALIGNMENT);
+
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const PackedRegion& region : atlas.regions) {
+            FileRegion entry{};
+            std::strncpy(entry.name, region.name.c_str(), NAME_SIZE - 1);
+            entry.x      = region.x;
+            entry.y      = region.y;
+            entry.width  = region.width;
+            entry.height = region.height;
+            out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+
+        const char padding[PIXEL_ALIGNMENT] = {};
+        out.write(padding, static_cast<std::streamsize>(header.pixel_offset - static_cast<std::uint64_t>(out.tellp())));
+        out.write(reinterpret_cast<const char*>(atlas.pixels),
+                  static_cast<std::streamsize>(static_cast<std::size_t>(atlas.width) * atlas.height * 4));
+        if (!out) return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+bool AtlasCache::Read(const std::string_view data, const std::uint64_t fingerprint, PackedAtlas& atlas) {
+    FileHeader header;
+    if (data.size() < sizeof(header)) return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.fingerprint != fingerprint) {
+        return false;
+    }
+    if (header.width == 0 || header.height == 0 || header.width > MAX_SIZE || header.height > MAX_SIZE) return false;
+
+    const std::size_t table_end   = sizeof(FileHeader) + sizeof(FileRegion) * header.region_count;
+    const std::size_t pixel_bytes = static_cast<std::size_t>(header.width) * header.height * 4;
+    if (header.pixel_offset < table_end || data.size() != header.pixel_offset + pixel_bytes) return false;
+
+    atlas.width   = header.width;
+    atlas.height  = header.height;
+    atlas.white_x = header.white_x;
+    atlas.white_y = header.white_y;
+    atlas.regions.clear();
+    atlas.regions.reserve(header.region_count);
+    for (std::uint32_t i = 0; i < header.region_count; i++) {
+        FileRegion entry;
+        std::memcpy(&entry, data.data() + sizeof(FileHeader) + sizeof(FileRegion) * i, sizeof(entry));
+        entry.name[NAME_SIZE - 1] = '\0';
+        if (entry.x + entry.width > header.width || entry.y + entry.height > header.height) return false;
+        atlas.regions.push_back(PackedRegion{entry.name, entry.x, entry.y, entry.width, entry.height});
+    }
+
+    atlas.storage.clear();
+    atlas.pixels = reinterpret_cast<const unsigned char*>(data.data() + header.pixel_offset);
+    return true;
+}
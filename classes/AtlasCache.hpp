@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief One image's rectangle inside a packed atlas, in pixels
+ */
+struct PackedRegion {
+    std::string   name;
+    std::uint32_t x      = 0;
+    std::uint32_t y      = 0;
+    std::uint32_t width  = 0;
+    std::uint32_t height = 0;
+};
+
+/**
+ * @brief A packed RGBA8 atlas ready to be uploaded as is.
+ *
+ * pixels either points into storage (freshly packed) or straight into a mapped cache file, in which case the mapping
+ * has to stay open until the pixels are uploaded.
+ */
+struct PackedAtlas {
+    std::uint32_t              width   = 0;
+    std::uint32_t              height  = 0;
+    std::uint32_t              white_x = 0; // top-left of the solid white block
+    std::uint32_t              white_y = 0;
+    std::vector<PackedRegion>  regions;
+    const unsigned char*       pixels = nullptr;
+    std::vector<unsigned char> storage;
+};
+
+/**
+ * @brief Packs the PNGs in resources/ into one atlas and stores it on disk in a GPU-ready form, so startup can skip
+ * both PNG decoding and rectangle packing.
+ *
+ * The cache file is a small header, the region table and the raw RGBA8 pixels (16-byte aligned). It records a
+ * fingerprint of the source images and is ignored when they change, in which case the caller packs from the PNGs and
+ * rewrites it. The texcache tool builds the same file offline.
+ */
+namespace AtlasCache {
+    /// Written next to the images it was built from.
+    inline constexpr const char* FILE_NAME = "atlas.cache";
+
+    /// Transparent border around each image so linear filtering never samples a neighbour.
+    inline constexpr int PADDING = 1;
+    /// Size of the solid white block (the white texel is sampled from its center, away from the filtered edge).
+    inline constexpr int WHITE_BLOCK = 3;
+    inline constexpr int MAX_SIZE    = 8192;
+
+    /**
+     * @brief Hash of the names and contents of every .png in a directory (not recursive)
+     */
+    std::uint64_t Fingerprint(const std::filesystem::path& directory);
+
+    /**
+     * @brief Decode and pack every .png in a directory
+     * @param error Set to a description of the problem on failure
+     * @return true if the atlas was packed
+     */
+    bool Pack(const std::filesystem::path& directory, PackedAtlas& atlas, std::string& error);
+
+    /**
+     * @brief Write an atlas to a cache file (through a temporary file, so a crash never leaves a torn cache)
+     * @return true on success
+     */
+    bool Write(const std::filesystem::path& path, const PackedAtlas& atlas, std::uint64_t fingerprint);
+
+    /**
+     * @brief Parse a cache file's contents without copying the pixels
+     * @param data The whole cache file, usually a MappedFile's View()
+     * @param fingerprint Fingerprint of the current images; a cache built from other images is rejected
+     * @return true if the cache is valid and up to date
+     */
+    bool Read(std::string_view data, std::uint64_t fingerprint, PackedAtlas& atlas);
+} // namespace AtlasCache
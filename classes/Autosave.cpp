@@ -0,0 +1,316 @@
+#include "classes/Autosave.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "classes/MappedFile.hpp"
+#include "classes/Tracer.hpp"
+
+#ifdef WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char          SNAPSHOT_MAGIC[8]   = {'T', 'T', 'T', 'S', 'A', 'V', 'E', 'D'};
+    constexpr std::uint32_t VERSION             = 1;
+    constexpr std::uint8_t  RECORD_TURN         = 1;
+    constexpr std::uint8_t  RECORD_SEEK         = 2;
+    constexpr const char*   TEMPORARY_EXTENSION = ".tmp";
+
+    struct SnapshotHeader {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t generation;
+        std::uint32_t cells;
+        std::uint32_t move_count;
+        std::uint32_t move_bytes;
+        std::uint32_t turn_no;
+        std::uint16_t players;
+        std::uint16_t reserved;
+        std::uint32_t checksum; // of the header (with this field zero) and everything after it
+    };
+
+    void HashBytes(std::uint64_t& hash, const void* bytes, const std::size_t size) {
+        // FNV-1a
+        const auto* data = static_cast<const unsigned char*>(bytes);
+        for (std::size_t i = 0; i < size; i++) {
+            hash ^= data[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    std::uint32_t Checksum(const void* bytes, const std::size_t size) {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        HashBytes(hash, bytes, size);
+        return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+    }
+
+    // unbuffered file access, so a sync covers everything written before it
+#ifdef WIN32
+    int OpenFile(const std::filesystem::path& path, const int flags) {
+        return _wopen(path.c_str(), flags | _O_WRONLY | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+    }
+    constexpr int APPEND   = _O_APPEND;
+    constexpr int TRUNCATE = _O_TRUNC;
+    bool          SyncFile(const int file) { return _commit(file) == 0; }
+    bool          EmptyFile(const int file) { return _chsize(file, 0) == 0; }
+    void          CloseFile(const int file) { _close(file); }
+    // renaming is only durable once the directory is, Windows has no portable way to sync one
+    void          SyncDirectory(const std::filesystem::path&) {}
+
+    bool WriteFile(const int file, const void* bytes, std::size_t size) {
+        const auto* data = static_cast<const char*>(bytes);
+        while (size > 0) {
+            const int written = _write(file, data, static_cast<unsigned int>(std::min<std::size_t>(size, 1u << 30)));
+            if (written <= 0) return false;
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+#else
+    int OpenFile(const std::filesystem::path& path, const int flags) {
+        return open(path.c_str(), flags | O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    }
+    constexpr int APPEND   = O_APPEND;
+    constexpr int TRUNCATE = O_TRUNC;
+#ifdef __APPLE__
+    bool SyncFile(const int file) { return fsync(file) == 0; }
+#else
+    // the file's data and size, without waiting on metadata like the modification time
+    bool SyncFile(const int file) { return fdatasync(file) == 0; }
+#endif
+    bool EmptyFile(const int file) { return ftruncate(file, 0) == 0; }
+    void CloseFile(const int file) { close(file); }
+
+    void SyncDirectory(const std::filesystem::path& directory) {
+        const int file = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) return;
+        fsync(file);
+        close(file);
+    }
+
+    bool WriteFile(const int file, const void* bytes, std::size_t size) {
+        const auto* data = static_cast<const char*>(bytes);
+        while (size > 0) {
+            const ssize_t written = write(file, data, size);
+            if (written <= 0) return false;
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+#endif
+} // namespace
+
+Autosave::~Autosave() {
+    Close();
+}
+
+bool Autosave::Load(const std::filesystem::path& path, MoveLog& log, std::uint32_t& turn_no) {
+    std::filesystem::path journal_file_path = path;
+    journal_file_path += JOURNAL_EXTENSION;
+
+    generation  = 0;
+    bool loaded = false;
+    {
+        MappedFile     snapshot;
+        SnapshotHeader header;
+        if (snapshot.Open(path) && snapshot.Size() >= sizeof(header)) {
+            std::memcpy(&header, snapshot.Data(), sizeof(header));
+            const std::uint32_t checksum = header.checksum;
+            header.checksum              = 0;
+            std::uint64_t hash           = 0xcbf29ce484222325ull;
+            HashBytes(hash, &header, sizeof(header));
+            HashBytes(hash, snapshot.Data() + sizeof(header), snapshot.Size() - sizeof(header));
+
+            if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 && header.version == VERSION &&
+                snapshot.Size() == sizeof(header) + static_cast<std::uint64_t>(header.cells) + header.move_bytes &&
+                static_cast<std::uint32_t>(hash ^ (hash >> 32)) == checksum && header.players > 0) {
+                const auto* data = reinterpret_cast<const std::uint8_t*>(snapshot.Data() + sizeof(header));
+                log.Reset(header.cells, header.players, data);
+                const std::uint8_t* moves  = data + header.cells;
+                std::size_t         offset = 0;
+                for (std::uint32_t i = 0; i < header.move_count && offset < header.move_bytes; i++) {
+                    MoveLog::Move move;
+                    offset += MoveLog::DecodeMove(moves + offset, move);
+                    log.Append(move);
+                }
+                turn_no    = std::min<std::uint32_t>(header.turn_no, static_cast<std::uint32_t>(log.Size()));
+                generation = header.generation;
+                loaded     = true;
+            }
+        }
+    }
+
+    // replay the turns played since the snapshot. the newest generation seen anywhere is kept, so the next snapshot
+    // can't be mistaken for one whose records are still in the journal
+    MappedFile journal_file;
+    if (journal_file.Open(journal_file_path)) {
+        const std::uint32_t snapshot_generation = generation;
+        bool                replaying           = loaded;
+        const std::size_t   records             = journal_file.Size() / sizeof(JournalRecord);
+        for (std::size_t i = 0; i < records; i++) {
+            JournalRecord record;
+            std::memcpy(&record, journal_file.Data() + i * sizeof(JournalRecord), sizeof(record));
+            // torn by a crash, nothing after it was made durable
+            if (Checksum(&record, offsetof(JournalRecord, checksum)) != record.checksum) break;
+            generation = std::max(generation, record.generation);
+            if (!replaying || record.generation != snapshot_generation) continue;
+
+            if (record.kind == RECORD_TURN && record.turn_no > 0 && record.turn_no - 1 <= log.Size()) {
+                log.Truncate(record.turn_no - 1);
+                log.Append(MoveLog::Move{record.from, record.to});
+                turn_no = record.turn_no;
+            }
+            else if (record.kind == RECORD_SEEK && record.turn_no <= log.Size()) {
+                turn_no = record.turn_no;
+            }
+            else {
+                replaying = false;
+            }
+        }
+    }
+    return loaded;
+}
+
+bool Autosave::Open(const std::filesystem::path& path) {
+    Close();
+
+    snapshot_path = path;
+    journal_path  = path;
+    journal_path += JOURNAL_EXTENSION;
+    journal = OpenFile(journal_path, APPEND);
+    if (journal < 0) return false;
+
+    since_compaction = 0;
+    stopping         = false;
+    writer           = std::thread(&Autosave::WriterLoop, this);
+    return true;
+}
+
+void Autosave::Close() {
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    writer.join();
+    CloseFile(journal);
+    journal = -1;
+}
+
+void Autosave::Snapshot(const MoveLog& log, const std::uint32_t turn_no) {
+    if (!IsOpen()) return;
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version    = VERSION;
+    header.generation = ++generation;
+    header.cells      = static_cast<std::uint32_t>(log.Cells());
+    header.move_count = static_cast<std::uint32_t>(log.Size());
+    header.move_bytes = static_cast<std::uint32_t>(log.Encoded().size());
+    header.turn_no    = turn_no;
+    header.players    = static_cast<std::uint16_t>(log.Players());
+
+    std::vector<std::uint8_t> bytes(sizeof(header) + header.cells + header.move_bytes);
+    log.BoardAt(0, bytes.data() + sizeof(header));
+    std::copy(log.Encoded().begin(), log.Encoded().end(), bytes.begin() + sizeof(header) + header.cells);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    header.checksum = Checksum(bytes.data(), bytes.size());
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    since_compaction = 0;
+
+    {
+        std::lock_guard lock(mutex);
+        // the snapshot already holds every turn still waiting to be journaled
+        pending_records.clear();
+        pending_snapshot.swap(bytes);
+    }
+    wake.notify_one();
+}
+
+void Autosave::RecordTurn(const MoveLog& log, const std::uint32_t turn_no) {
+    if (turn_no == 0 || turn_no > log.Size()) return;
+    Record(log, RECORD_TURN, log.MoveAt(turn_no - 1), turn_no);
+}
+
+void Autosave::RecordSeek(const MoveLog& log, const std::uint32_t turn_no) {
+    Record(log, RECORD_SEEK, MoveLog::Move{}, turn_no);
+}
+
+void Autosave::Record(const MoveLog& log, const std::uint8_t kind, const MoveLog::Move& move,
+                      const std::uint32_t turn_no) {
+    if (!IsOpen()) return;
+    if (++since_compaction >= COMPACT_INTERVAL) {
+        Snapshot(log, turn_no);
+        return;
+    }
+
+    JournalRecord record{};
+    record.generation = generation;
+    record.turn_no    = turn_no;
+    record.from       = move.from;
+    record.to         = move.to;
+    record.kind       = kind;
+    record.checksum   = Checksum(&record, offsetof(JournalRecord, checksum));
+    {
+        std::lock_guard lock(mutex);
+        pending_records.push_back(record);
+    }
+    wake.notify_one();
+}
+
+void Autosave::WriterLoop() {
+    Tracer::GetInstance().SetThreadName("autosave writer");
+
+    std::vector<JournalRecord> records;
+    std::vector<std::uint8_t>  snapshot;
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this] { return stopping || !pending_records.empty() || !pending_snapshot.empty(); });
+            if (pending_records.empty() && pending_snapshot.empty()) return; // stopping, and everything is synced
+            records.swap(pending_records);
+            snapshot.swap(pending_snapshot);
+        }
+
+        if (!snapshot.empty()) {
+            TRACE_SCOPE("Autosave snapshot");
+            // the journal only starts over once the snapshot replacing it is on disk; if it can't be written, the
+            // records that follow carry a generation the old snapshot doesn't have and are ignored when loading
+            if (WriteSnapshot(snapshot)) EmptyFile(journal);
+            snapshot.clear();
+        }
+        if (!records.empty()) {
+            // everything queued while the last sync ran goes out in one write and one sync
+            TRACE_SCOPE("Autosave journal sync");
+            if (WriteFile(journal, records.data(), records.size() * sizeof(JournalRecord))) SyncFile(journal);
+            records.clear();
+        }
+    }
+}
+
+bool Autosave::WriteSnapshot(const std::vector<std::uint8_t>& bytes) {
+    std::filesystem::path temporary = snapshot_path;
+    temporary += TEMPORARY_EXTENSION;
+
+    const int file = OpenFile(temporary, TRUNCATE);
+    if (file < 0) return false;
+    const bool written = WriteFile(file, bytes.data(), bytes.size()) && SyncFile(file);
+    CloseFile(file);
+    if (!written) return false;
+
+    std::error_code error;
+    std::filesystem::rename(temporary, snapshot_path, error);
+    if (error) return false;
+    SyncDirectory(snapshot_path.parent_path());
+    return true;
+}
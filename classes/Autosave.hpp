@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "classes/MoveLog.hpp"
+
+/**
+ * @brief Crash-safe autosave of the game in progress: a snapshot plus a write-ahead journal of the turns since.
+ *
+ * The snapshot (the autosave's path) holds a whole MoveLog: the starting board, the encoded moves and the turn the game
+ * is at. The journal next to it (the path plus JOURNAL_EXTENSION) gets one small fixed-size record per turn played or
+ * per jump through the history, so a turn costs an append instead of rewriting a file. Every COMPACT_INTERVAL records
+ * (and whenever a new game starts) the journal is folded into a fresh snapshot, written to a temporary file and renamed
+ * over the old one, after which the journal starts over.
+ *
+ * Records carry the generation of the snapshot they follow and a checksum, so a record torn by a crash ends the replay
+ * and records left behind by an older snapshot are ignored instead of being applied twice.
+ *
+ * Recording only queues the record; the autosave's own thread writes whatever has queued up since its last write and
+ * makes it durable with a single fdatasync(), so a burst of turns (AI against AI) costs one sync rather than one each.
+ */
+class Autosave {
+public:
+    static constexpr const char*   JOURNAL_EXTENSION = ".journal";
+    static constexpr std::uint32_t COMPACT_INTERVAL  = 64;
+
+    static Autosave& GetInstance() {
+        static Autosave instance;
+        return instance;
+    }
+
+    Autosave(const Autosave&)            = delete;
+    Autosave& operator=(const Autosave&) = delete;
+
+    /**
+     * @brief Read the saved game: the snapshot with every valid journal record replayed on top of it
+     * @param log Receives the game's moves
+     * @param turn_no Receives the turn the game was at
+     * @return false if there is no usable snapshot
+     */
+    bool Load(const std::filesystem::path& path, MoveLog& log, std::uint32_t& turn_no);
+    /**
+     * @brief Open the journal for appending and start the writer. Call Load() first so the generations carry on.
+     * @return true if the journal could be opened
+     */
+    bool Open(const std::filesystem::path& path);
+    /**
+     * @brief Write everything still queued, sync it and close the journal
+     */
+    void Close();
+    inline bool IsOpen() const { return writer.joinable(); };
+
+    /**
+     * @brief Queue a snapshot of the whole game, replacing the journal. Used when a game starts or is restored.
+     */
+    void Snapshot(const MoveLog& log, std::uint32_t turn_no);
+    /**
+     * @brief Journal the turn that took the game to turn_no (the last move in log before turn_no)
+     */
+    void RecordTurn(const MoveLog& log, std::uint32_t turn_no);
+    /**
+     * @brief Journal a jump through the history (undo, redo or seek) to turn_no
+     */
+    void RecordSeek(const MoveLog& log, std::uint32_t turn_no);
+
+private:
+    Autosave() = default;
+    ~Autosave();
+
+    struct JournalRecord {
+        std::uint32_t generation; // the snapshot this record follows
+        std::uint32_t turn_no;    // the turn the game is at after it
+        std::uint32_t from;       // the turn's MoveLog::Move, both NO_CELL for a seek
+        std::uint32_t to;
+        std::uint8_t  kind;
+        std::uint8_t  reserved[3];
+        std::uint32_t checksum;
+    };
+
+    void Record(const MoveLog& log, std::uint8_t kind, const MoveLog::Move& move, std::uint32_t turn_no);
+    void WriterLoop();
+    bool WriteSnapshot(const std::vector<std::uint8_t>& bytes);
+
+    std::filesystem::path snapshot_path;
+    std::filesystem::path journal_path;
+
+    std::mutex                 mutex;
+    std::condition_variable    wake;
+    std::vector<JournalRecord> pending_records;
+    std::vector<std::uint8_t>  pending_snapshot; // empty when no snapshot is waiting
+    bool                       stopping = false;
+    std::thread                writer;
+
+    // only touched by the writer thread while it runs
+    int journal = -1;
+
+    // only touched by the thread recording turns
+    std::uint32_t generation       = 0;
+    std::uint32_t since_compaction = 0;
+};
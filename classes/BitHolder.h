@@ -6,7 +6,7 @@ class Bit;
 class BitHolder : public Sprite
 {
 public:
-	BitHolder() : Sprite() { _bit = nullptr; _gameTag = 0; };
+	BitHolder() : Sprite() { _bit = nullptr; _gameTag = 0; _boardCell = -1; };
 	~BitHolder();
 
 	// current piece or nullptr if empty
@@ -20,6 +20,9 @@ public:
 	int		gameTag() { return _gameTag; };
 	// set the gametag
 	void	setGameTag(int tag) { _gameTag = tag; };
+	// index on the game board (y * columns + x), set by Game::startGame; -1 for holders that aren't on the board
+	int		boardCell() const { return _boardCell; };
+	void	setBoardCell(int cell) { _boardCell = cell; };
 	// convenience function to see if the holder is empty
 	virtual bool	empty() { return _bit == nullptr; };
 
@@ -51,5 +54,6 @@ public:
 protected:
 	Bit		*_bit;
 	int		_gameTag;
+	int		_boardCell;
 };
 
@@ -0,0 +1,181 @@
+#include "classes/BoardDrawCache.hpp"
+
+#include <algorithm>
+
+#include "classes/Game.h"
+#include "classes/Profiler.hpp"
+#include "classes/TextureAtlas.hpp"
+
+/// Sprites emitted per PrimReserve(), keeping each batch well inside 16-bit indices.
+static constexpr std::size_t SPRITES_PER_BATCH = 12288;
+
+void BoardDrawCache::Invalidate() {
+    columns = rows = 0;
+    cells.clear();
+    batch.Resize(0);
+}
+
+// an empty slot: zero area, so the rasterizer drops it
+static constexpr SpriteInstance EMPTY_SPRITE{ImVec2(0, 0), ImVec2(0, 0), ImVec2(0, 0), ImVec2(0, 0), 0};
+
+void BoardDrawCache::BuildCell(Game& game, const int x, const int y) {
+    const std::size_t index  = static_cast<std::size_t>(y) * columns + x;
+    CellState&        state  = cells[index];
+    SpriteInstance*   sprite = &batch[index * QUADS_PER_CELL];
+    BitHolder&        holder = game.getHolderAt(x, y);
+    Bit*              bit    = holder.bit();
+
+    const bool was_cacheable = state.cacheable;
+    state.holder_version     = holder.drawVersion();
+    state.bit                = bit;
+    state.bit_version        = bit ? bit->drawVersion() : 0;
+    state.cacheable          = holder.getTexture() == texture && !holder.textureLoading() &&
+                      (!bit || (bit->getTexture() == texture && !bit->textureLoading()));
+    if (was_cacheable && !state.cacheable) {
+        uncacheable_cells++;
+    }
+    else if (!was_cacheable && state.cacheable) {
+        uncacheable_cells--;
+    }
+
+    const auto sprite_rect = [&](Sprite& sprite, ImVec2& min, ImVec2& max) {
+        min = ImVec2(origin.x + sprite.getPosition().x * scale, origin.y + sprite.getPosition().y * scale);
+        max = ImVec2(min.x + sprite.getSize().x * scale, min.y + sprite.getSize().y * scale);
+        board_size.x = std::max(board_size.x, sprite.getPosition().x + sprite.getSize().x);
+        board_size.y = std::max(board_size.y, sprite.getPosition().y + sprite.getSize().y);
+    };
+
+    ImVec2 min, max;
+    sprite_rect(holder, min, max);
+    sprite[0] = SpriteInstance{min, max, holder.getUV0(), holder.getUV1(), ImGui::GetColorU32(holder.getColor())};
+
+    // the same outline paintSprite() draws
+    if (holder.highlighted()) {
+        const ImU32  highlight = ImGui::GetColorU32(ImVec4(1, 1, 0, 1));
+        const ImVec2 white     = TextureAtlas::GetInstance().WhiteUV();
+        sprite[1] = SpriteInstance{min, ImVec2(max.x, min.y + 1), white, white, highlight};
+        sprite[2] = SpriteInstance{ImVec2(min.x, max.y - 1), max, white, white, highlight};
+        sprite[3] = SpriteInstance{ImVec2(min.x, min.y + 1), ImVec2(min.x + 1, max.y - 1), white, white, highlight};
+        sprite[4] = SpriteInstance{ImVec2(max.x - 1, min.y + 1), ImVec2(max.x, max.y - 1), white, white, highlight};
+    }
+    else {
+        for (int edge = 1; edge <= 4; edge++) sprite[edge] = EMPTY_SPRITE;
+    }
+
+    if (bit) {
+        sprite_rect(*bit, min, max);
+        sprite[5] = SpriteInstance{min, max, bit->getUV0(), bit->getUV1(), ImGui::GetColorU32(bit->getColor())};
+    }
+    else {
+        sprite[5] = EMPTY_SPRITE;
+    }
+    batch.MarkDirty(index * QUADS_PER_CELL, QUADS_PER_CELL);
+}
+
+void BoardDrawCache::AppendToDrawList(ImDrawList* draw_list) {
+    draw_list->PushTexture(texture);
+    for (std::size_t first = 0; first < batch.Size(); first += SPRITES_PER_BATCH) {
+        const std::size_t count = std::min(SPRITES_PER_BATCH, batch.Size() - first);
+        draw_list->PrimReserve(static_cast<int>(count) * 6, static_cast<int>(count) * 4);
+
+        ImDrawVert*     vertex = draw_list->_VtxWritePtr;
+        ImDrawIdx*      index  = draw_list->_IdxWritePtr;
+        const ImDrawIdx base   = static_cast<ImDrawIdx>(draw_list->_VtxCurrentIdx);
+        for (std::size_t i = 0; i < count; i++, vertex += 4, index += 6) {
+            const SpriteInstance& sprite = batch[first + i];
+            vertex[0] = ImDrawVert{sprite.min, sprite.uv0, sprite.color};
+            vertex[1] = ImDrawVert{ImVec2(sprite.max.x, sprite.min.y), ImVec2(sprite.uv1.x, sprite.uv0.y), sprite.color};
+            vertex[2] = ImDrawVert{sprite.max, sprite.uv1, sprite.color};
+            vertex[3] = ImDrawVert{ImVec2(sprite.min.x, sprite.max.y), ImVec2(sprite.uv0.x, sprite.uv1.y), sprite.color};
+
+            const ImDrawIdx corner = static_cast<ImDrawIdx>(base + i * 4);
+            index[0] = corner;
+            index[1] = static_cast<ImDrawIdx>(corner + 1);
+            index[2] = static_cast<ImDrawIdx>(corner + 2);
+            index[3] = corner;
+            index[4] = static_cast<ImDrawIdx>(corner + 2);
+            index[5] = static_cast<ImDrawIdx>(corner + 3);
+        }
+
+        draw_list->_VtxWritePtr = vertex;
+        draw_list->_IdxWritePtr = index;
+        draw_list->_VtxCurrentIdx += static_cast<unsigned int>(count) * 4;
+    }
+    draw_list->PopTexture();
+}
+
+bool BoardDrawCache::Update(Game& game, const ImVec2& screen_origin, const float new_scale) {
+    const TextureAtlas& atlas = TextureAtlas::GetInstance();
+    if (!atlas.IsBuilt()) return false;
+
+    rebuilt_cells = 0;
+    const int new_columns = game._gameOptions.rowX;
+    const int new_rows    = game._gameOptions.rowY;
+    if (new_columns != columns || new_rows != rows || screen_origin.x != origin.x || screen_origin.y != origin.y ||
+        new_scale != scale || atlas.Texture() != texture) {
+        // layout, window position, scale or texture changed: every cell moves
+        columns = new_columns;
+        rows    = new_rows;
+        origin  = screen_origin;
+        scale   = new_scale;
+        texture = atlas.Texture();
+        cells.assign(static_cast<std::size_t>(columns) * rows, CellState{});
+        batch.Resize(cells.size() * QUADS_PER_CELL);
+        uncacheable_cells = cells.size();
+        board_size        = ImVec2(0, 0);
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < columns; x++) BuildCell(game, x, y);
+        }
+        rebuilt_cells = cells.size();
+    }
+    else {
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < columns; x++) {
+                BitHolder&       holder = game.getHolderAt(x, y);
+                const CellState& state  = cells[static_cast<std::size_t>(y) * columns + x];
+                // updateTexture() may be what changes the version, so call it before comparing
+                if (holder.textureLoading()) holder.updateTexture();
+                Bit* bit = holder.bit();
+                if (bit && bit->textureLoading()) bit->updateTexture();
+                if (state.holder_version != holder.drawVersion() || state.bit != bit ||
+                    (bit && state.bit_version != bit->drawVersion())) {
+                    BuildCell(game, x, y);
+                    rebuilt_cells++;
+                }
+            }
+        }
+    }
+    PROFILE_COUNTER_ADD("Board cells rebuilt", rebuilt_cells);
+
+    return uncacheable_cells == 0;
+}
+
+bool BoardDrawCache::Draw(Game& game) {
+    PROFILE_ZONE("BoardDrawCache::Draw");
+
+    ImGui::SetCursorPos(ImVec2(0, 0));
+    if (!Update(game, ImGui::GetCursorScreenPos(), 1.0f)) return false;
+
+    // one item covering the board, so the window sizes its content (and scrollbars) like it does for the sprites
+    ImGui::Dummy(board_size);
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    if (SpriteBatch::Available()) {
+        batch.Draw(draw_list, texture);
+    }
+    else {
+        AppendToDrawList(draw_list);
+    }
+    return true;
+}
+
+bool BoardDrawCache::Draw(Game& game, ImDrawList* draw_list, const ImVec2& screen_origin, const float new_scale) {
+    PROFILE_ZONE("BoardDrawCache::Draw");
+
+    if (!Update(game, screen_origin, new_scale)) return false;
+
+    // a board is only a few dozen sprites: expanded into the draw list, every board drawn into the same list shares one
+    // draw command, where an instanced draw would be a callback (and its GL state setup) per board
+    AppendToDrawList(draw_list);
+    return true;
+}
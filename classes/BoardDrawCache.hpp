@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "imgui/imgui.h"
+
+#include "classes/SpriteBatch.hpp"
+
+class Bit;
+class Game;
+
+/**
+ * @brief Retained drawing of a game board: the vertices of every cell are kept between frames and only the cells whose
+ * holder or bit changed (bit placed or removed, highlight, color, texture) are rebuilt.
+ *
+ * Each cell owns a fixed slot of sprites in a SpriteBatch, so a cell can be rebuilt in place. With an instancing
+ * renderer an idle frame is a version check per cell and one instanced draw of the batch, which only re-uploads the
+ * cells that changed; otherwise the cached sprites are expanded into the window's draw list. The whole board must come
+ * from one texture (the atlas); Draw() returns false otherwise and the caller paints the sprites one by one.
+ */
+class BoardDrawCache {
+public:
+    /// holder image, the four edges of its highlight, bit image
+    static constexpr int QUADS_PER_CELL = 6;
+
+    /**
+     * @brief Drop everything, forcing a full rebuild on the next Draw()
+     */
+    void Invalidate();
+
+    /**
+     * @brief Append the board to the current window's draw list, rebuilding the cells that changed
+     * @return false if the board can't be drawn from the cache this frame
+     */
+    bool Draw(Game& game);
+
+    /**
+     * @brief Append the board to a draw list with its (0, 0) at screen_origin and every sprite scaled, e.g. as one tile
+     * of many boards in a window. Doesn't submit any imgui item, laying out the tile is up to the caller. The sprites are
+     * always expanded into the draw list, so any number of boards drawn this way stay one draw command.
+     * @return false if the board can't be drawn from the cache this frame
+     */
+    bool Draw(Game& game, ImDrawList* draw_list, const ImVec2& screen_origin, float scale);
+
+    /// Cells rebuilt by the last Draw().
+    inline std::size_t RebuiltCells() const { return rebuilt_cells; };
+
+private:
+    struct CellState {
+        unsigned int holder_version = 0;
+        const Bit*   bit            = nullptr;
+        unsigned int bit_version    = 0;
+        bool         cacheable      = false;
+    };
+
+    bool Update(Game& game, const ImVec2& screen_origin, float new_scale);
+    void BuildCell(Game& game, int x, int y);
+    void AppendToDrawList(ImDrawList* draw_list);
+
+    int                     columns = 0;
+    int                     rows    = 0;
+    ImVec2                  origin{0, 0}; // screen position of the window's content origin when the cache was built
+    float                   scale = 1.0f;
+    ImTextureID             texture = 0;
+    std::vector<CellState>  cells;
+    SpriteBatch             batch;
+    std::size_t             uncacheable_cells = 0;
+    ImVec2                  board_size{0, 0};
+    std::size_t             rebuilt_cells = 0;
+};
@@ -14,6 +14,8 @@ public:
 
     Entity() : _entityType(EntityNone), _parent(nullptr), _retainCount(0) {};
     Entity(EntityType type) : _entityType(type) {};
+    // release() deletes through an Entity pointer, so subclasses need their destructors to run
+    virtual ~Entity() = default;
 
     EntityType getEntityType() {return _entityType; }
     
@@ -33,6 +35,8 @@ public:
     void release() { _retainCount--; if (_retainCount <= 0) removeFromParentAndCleanup(true); }
     // release the sprite from the list being drawn
     void retain() { _retainCount++;}
+    // drop a reference without cleaning up at zero, so an entity kept for reuse can go to a new owner that retains it
+    void releaseForReuse() { _retainCount--; }
 
 protected:
     EntityType _entityType;
@@ -0,0 +1,57 @@
+#include "classes/FrameScheduler.hpp"
+
+#include "classes/Tracer.hpp"
+
+FrameScheduler& FrameScheduler::GetInstance() {
+    static FrameScheduler instance;
+    return instance;
+}
+
+void FrameScheduler::RequestFrame() {
+    // only the first request since the last frame needs to wake the loop
+    if (!frame_requested.exchange(true, std::memory_order_acq_rel) && wake_function) {
+        wake_function();
+    }
+}
+
+void FrameScheduler::SetPowerSaving(const bool enabled) {
+    power_saving  = enabled;
+    settle_frames = SETTLE_FRAMES;
+}
+
+void FrameScheduler::WaitForEvents(void (*wait)(double timeout)) {
+    const auto now = Clock::now();
+
+    // roll the stats window over every second
+    const auto window = now - window_start;
+    if (window >= std::chrono::seconds(1)) {
+        const double seconds = std::chrono::duration<double>(window).count();
+        frames_per_second    = window_frames / seconds;
+        idle_ratio           = std::chrono::duration<double>(window_idle).count() / seconds;
+        window_start         = now;
+        window_idle          = {};
+        window_frames        = 0;
+    }
+    window_frames++;
+
+    if (frame_requested.exchange(false, std::memory_order_acq_rel)) {
+        settle_frames = SETTLE_FRAMES;
+    }
+
+    if (!power_saving || settle_frames > 0) {
+        if (settle_frames > 0) settle_frames--;
+        return;
+    }
+
+    {
+        TRACE_SCOPE("FrameScheduler::WaitForEvents");
+        wait(MAX_IDLE_WAIT);
+    }
+    const auto waited = Clock::now() - now;
+    window_idle += waited;
+
+    // woken by input or RequestFrame() rather than the timeout, so keep drawing for a few frames
+    if (waited < std::chrono::duration<double>(MAX_IDLE_WAIT) || frame_requested.load(std::memory_order_acquire)) {
+        settle_frames = SETTLE_FRAMES;
+    }
+}
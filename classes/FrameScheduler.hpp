@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * @brief Decides whether the render loop can sleep until the next input event (power-saving mode).
+ *
+ * Anything that needs the screen updated without user input (an AI move finishing on a worker thread, a new log
+ * entry, a finished turn) calls RequestFrame(), which is safe from any thread and wakes a sleeping loop through the
+ * platform's wake function (glfwPostEmptyEvent on GLFW).
+ */
+class FrameScheduler {
+    FrameScheduler() = default;
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Frames drawn after any wakeup, so imgui can settle hover/animation state before we sleep again.
+    static constexpr int SETTLE_FRAMES = 3;
+
+    /// Longest the loop sleeps with nothing happening (keeps imgui timers such as ini saving ticking).
+    static constexpr double MAX_IDLE_WAIT = 1.0;
+
+    static FrameScheduler& GetInstance();
+
+    /**
+     * @brief Set the function used to break the render loop out of its event wait. Must be safe to call from any thread.
+     */
+    void SetWakeFunction(void (*wake)()) { wake_function = wake; };
+
+    /**
+     * @brief Ask for another frame as soon as possible. Safe to call from any thread.
+     */
+    void RequestFrame();
+
+    /**
+     * @brief Called once per loop iteration before polling events. Blocks in wait(timeout) when there is nothing to do.
+     * @param wait Platform event wait with a timeout in seconds (e.g. glfwWaitEventsTimeout)
+     */
+    void WaitForEvents(void (*wait)(double timeout));
+
+    bool PowerSaving() const { return power_saving; };
+    void SetPowerSaving(bool enabled);
+
+    /// Frames rendered per second over the last complete second.
+    double FramesPerSecond() const { return frames_per_second; };
+    /// Fraction of the last complete second spent blocked waiting for events.
+    double IdleRatio() const { return idle_ratio; };
+
+private:
+    void (*wake_function)() = nullptr;
+    std::atomic<bool> frame_requested{true};
+    bool              power_saving  = true;
+    int               settle_frames = SETTLE_FRAMES;
+
+    // stats
+    Clock::time_point window_start = Clock::now();
+    Clock::duration   window_idle{};
+    int               window_frames     = 0;
+    double            frames_per_second = 0.0;
+    double            idle_ratio        = 0.0;
+};
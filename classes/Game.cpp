@@ -1,8 +1,11 @@
 #include "Game.h"
 #include "Bit.h"
 #include "BitHolder.h"
-#include "Turn.h"
-#include "../Application.h"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <ctime>
 
 Game::Game()
 {
@@ -20,17 +23,24 @@ Game::Game()
 	_score = 0;
 	_table = nullptr;
 	_winner = nullptr;
+	_draw = false;
 	_lastMove = "";
-	_gameNumber = -1;
+	_stateVersion = 0;
+	_boardOrigin = ImVec2(0, 0);
+	_cellSize = ImVec2(0, 0);
+	_hoveredHolder = nullptr;
+	_retainedDraw = true;
+	_aiEnabled = true;
 }
 
 
 Game::~Game()
 {
-	for (auto & _turn : _turns) {
-		delete _turn;
+	recycleUndoneBits();
+	for (Bit *bit : _spareBits) {
+		bit->release();
 	}
-	_turns.clear();
+	_spareBits.clear();
 	for (auto & _player : _players) {
 		delete _player;
 	}
@@ -45,57 +55,342 @@ Game::~Game()
 
 void Game::setNumberOfPlayers(unsigned int n)
 {
-	_players.clear();
+	// the players of the last game are reused, only the ones no longer needed (and any bits they own) are freed
+	if (_players.size() > n) {
+		for (Bit *bit : _spareBits) {
+			bit->release();
+		}
+		_spareBits.clear();
+		for (size_t i = n; i < _players.size(); i++) {
+			delete _players[i];
+		}
+		_players.resize(n);
+	}
 	for (unsigned int i = 1; i <= n; i++)
 	{
-		Player *player = Player::initWithGame(this);
+		if (i > _players.size()) {
+			_players.push_back(Player::initWithGame(this));
+		}
+		Player *player = _players[i-1];
 //		player->setName( std::format( "Player-{}", i ) );
 		player->setName( "Player" );
 		player->setPlayerNumber(i-1);			// player numbers are zero-based
-		_players.push_back(player);
+		player->setAIPlayer(false);
 	}
 	_winner = nullptr;
-	_gameNumber = 0;
 	_gameOptions.numberOfPlayers = n;
-	Turn *turn = Turn::initStartOfGame(this);
-	_turns.clear();
-	_turns.push_back(turn);
 }
 
 void Game::setAIPlayer(unsigned int playerNumber)
 {
-	_players.at(playerNumber)->setAIPlayer(true);
+	_players.at(playerNumber)->setAIPlayer(_aiEnabled);
 	_gameOptions.AIPlayer = playerNumber;
-	_gameOptions.AIPlaying = true;
+	_gameOptions.AIPlaying = _aiEnabled;
+	if (_gameOptions.AIvsAI) {
+		for (Player *player : _players) {
+			player->setAIPlayer(_aiEnabled);
+		}
+	}
+}
+
+void Game::setAIEnabled(bool enabled)
+{
+	if (enabled == _aiEnabled) {
+		return;
+	}
+	_aiEnabled = enabled;
+	if (!gameHasAI() || _gameOptions.AIPlayer >= (int)_players.size()) {
+		return;
+	}
+	cancelAI();
+	for (size_t i = 0; i < _players.size(); i++) {
+		if (_gameOptions.AIvsAI || (int)i == _gameOptions.AIPlayer) {
+			_players[i]->setAIPlayer(enabled);
+		}
+	}
+	_gameOptions.AIPlaying = enabled;
+}
+
+void Game::setAIvsAI(bool enabled)
+{
+	if (enabled == _gameOptions.AIvsAI) {
+		return;
+	}
+	_gameOptions.AIvsAI = enabled;
+	if (!gameHasAI() || _gameOptions.AIPlayer >= (int)_players.size()) {
+		return;
+	}
+	cancelAI();
+	for (size_t i = 0; i < _players.size(); i++) {
+		_players[i]->setAIPlayer(_aiEnabled && (enabled || (int)i == _gameOptions.AIPlayer));
+	}
 }
 
 void Game::startGame()
 {
-	std::string startState = stateString();
-	Turn *turn = _turns.at(0);
-	turn->_boardState = startState;
-	turn->_gameNumber = _gameNumber;
+	for (int y=0; y<_gameOptions.rowY; y++) {
+		for (int x=0; x<_gameOptions.rowX; x++) {
+			getHolderAt(x, y).setBoardCell(y * _gameOptions.rowX + x);
+		}
+	}
+	std::vector<uint8_t> cells;
+	boardCells(cells);
+	_moveLog.Reset(cells.size(), _gameOptions.numberOfPlayers, cells.data());
+	recycleUndoneBits();
 	_gameOptions.currentTurnNo = 0;
+	markStateChanged();
+	updateResult();
 }
 
-void Game::endTurn()
+void Game::boardCells(std::vector<uint8_t> &cells)
 {
+	cells.resize((size_t)_gameOptions.rowX * _gameOptions.rowY);
+	for (int y=0; y<_gameOptions.rowY; y++) {
+		for (int x=0; x<_gameOptions.rowX; x++) {
+			Bit *bit = getHolderAt(x, y).bit();
+			Player *owner = bit ? bit->getOwner() : nullptr;
+			cells[y * _gameOptions.rowX + x] = owner ? (uint8_t)(owner->playerNumber() + 1) : 0;
+		}
+	}
+}
+
+GameRecord Game::gameRecord(int winner) const
+{
+	GameRecord record;
+	record.finished_at = (int64_t)std::time(nullptr);
+	record.winner = (int8_t)winner;
+	record.columns = (uint16_t)_gameOptions.rowX;
+	record.rows = (uint16_t)_gameOptions.rowY;
+	for (const Player *player : _players) {
+		record.players.push_back(player->isAIPlayer() ? GameArchive::PLAYER_AI : 0);
+	}
+	// the game as it is on screen: turns undone and not replayed since aren't part of it
+	record.move_count = _gameOptions.currentTurnNo;
+	record.start_board.resize(_moveLog.Cells());
+	_moveLog.BoardAt(0, record.start_board.data());
+	record.moves = _moveLog.Encoded();
+	if (_moveLog.Size() > record.move_count) {
+		MoveLog current;
+		current.Reset(_moveLog.Cells(), _moveLog.Players(), record.start_board.data());
+		for (unsigned int i = 0; i < record.move_count; i++) {
+			current.Append(_moveLog.MoveAt(i));
+		}
+		record.moves = current.Encoded();
+	}
+	return record;
+}
+
+BitHolder& Game::holderForCell(uint32_t cell)
+{
+	return getHolderAt((int)(cell % _gameOptions.rowX), (int)(cell / _gameOptions.rowX));
+}
+
+void Game::recycleUndoneBits()
+{
+	for (Bit *bit : _undoneBits) {
+		if (bit) {
+			_spareBits.push_back(bit);
+		}
+	}
+	_undoneBits.clear();
+}
+
+void Game::recycleBit(BitHolder &holder)
+{
+	Bit *bit = holder.bit();
+	if (!bit) {
+		return;
+	}
+	// the holder's reference becomes ours
+	bit->retain();
+	holder.destroyBit();
+	_spareBits.push_back(bit);
+}
+
+Bit* Game::reuseBit(Player *owner)
+{
+	for (size_t i = _spareBits.size(); i-- > 0; ) {
+		Bit *bit = _spareBits[i];
+		if (bit->getOwner() == owner) {
+			_spareBits[i] = _spareBits.back();
+			_spareBits.pop_back();
+			// handed out like a new bit, the holder it goes to takes its own reference
+			bit->releaseForReuse();
+			return bit;
+		}
+	}
+	return nullptr;
+}
+
+void Game::endTurn(BitHolder *dst, BitHolder *src)
+{
+	// a move made while looking at an earlier turn replaces everything that came after it
+	if (viewingHistory()) {
+		_moveLog.Truncate(_gameOptions.currentTurnNo);
+		recycleUndoneBits();
+	}
+	MoveLog::Move move;
+	if (dst && dst->boardCell() >= 0) {
+		move.to = (uint32_t)dst->boardCell();
+		if (src && src->boardCell() >= 0) {
+			move.from = (uint32_t)src->boardCell();
+		}
+	}
+	_moveLog.Append(move);
+
 	_gameOptions.currentTurnNo++;
-	std::string startState = stateString();
-	Turn *turn = new Turn;
-	turn->_boardState = stateString();
-	turn->_date = (int)_gameOptions.currentTurnNo;
-	turn->_score = _score;
-	turn->_gameNumber = _gameNumber;
-	_turns.push_back(turn);
-	ClassGame::EndOfTurn();
+	markStateChanged();
+	updateResult();
+	// the only place a win happens, undo, redo and seek just find it again
+	if (_winner) {
+		Logger::GetInstance().LogGameEventInfo("Detected win by player {}", _winner->playerNumber());
+	}
+	for (GameListener *listener : _listeners) {
+		listener->turnEnded(*this);
+		if (_winner) {
+			listener->gameWon(*this, *_winner);
+		} else if (_draw) {
+			listener->gameDrawn(*this);
+		}
+	}
+}
+
+Player* Game::checkForResult(bool &isDraw)
+{
+	Player *winner = checkForWinner();
+	isDraw = !winner && checkForDraw();
+	return winner;
+}
+
+void Game::updateResult()
+{
+	_winner = checkForResult(_draw);
+}
+
+void Game::addListener(GameListener *listener)
+{
+	_listeners.push_back(listener);
+}
+
+void Game::removeListener(GameListener *listener)
+{
+	_listeners.erase(std::remove(_listeners.begin(), _listeners.end(), listener), _listeners.end());
+}
+
+void Game::undoTurn()
+{
+	if (!canUndo()) {
+		return;
+	}
+	cancelAI();
+
+	_gameOptions.currentTurnNo--;
+	const MoveLog::Move move = _moveLog.MoveAt(_gameOptions.currentTurnNo);
+	if (move.to != MoveLog::NO_CELL) {
+		// keep the bit alive while it's off the board, so redo puts back the same one
+		BitHolder &dst = holderForCell(move.to);
+		Bit *bit = dst.bit();
+		if (bit) {
+			bit->retain();
+		}
+		dst.destroyBit();
+		if (move.from != MoveLog::NO_CELL) {
+			BitHolder &src = holderForCell(move.from);
+			if (bit) {
+				bit->setPosition(src.getPosition());
+				src.setBit(bit);
+				bit->release();
+			}
+		} else {
+			_undoneBits.push_back(bit);
+		}
+	}
+	markStateChanged();
+	updateResult();
+}
+
+void Game::redoTurn()
+{
+	if (!canRedo()) {
+		return;
+	}
+	cancelAI();
+
+	const MoveLog::Move move = _moveLog.MoveAt(_gameOptions.currentTurnNo);
+	_gameOptions.currentTurnNo++;
+	if (move.to != MoveLog::NO_CELL) {
+		Bit *bit = nullptr;
+		if (move.from != MoveLog::NO_CELL) {
+			BitHolder &src = holderForCell(move.from);
+			bit = src.bit();
+			if (bit) {
+				bit->retain();
+			}
+			src.destroyBit();
+		} else if (!_undoneBits.empty()) {
+			bit = _undoneBits.back();
+			_undoneBits.pop_back();
+		}
+		if (bit) {
+			BitHolder &dst = holderForCell(move.to);
+			bit->setPosition(dst.getPosition());
+			dst.setBit(bit);
+			bit->release();
+		}
+	}
+	markStateChanged();
+	updateResult();
+}
+
+void Game::seekToTurn(unsigned int turnNo)
+{
+	PROFILE_ZONE("Game::seekToTurn");
+
+	turnNo = std::min(turnNo, lastTurnNo());
+	while (_gameOptions.currentTurnNo > turnNo) {
+		undoTurn();
+	}
+	while (_gameOptions.currentTurnNo < turnNo) {
+		redoTurn();
+	}
+}
+
+bool Game::restoreGame(const MoveLog &log, unsigned int turnNo)
+{
+	if (log.Cells() != (size_t)_gameOptions.rowX * _gameOptions.rowY || (int)log.Players() != _gameOptions.numberOfPlayers ||
+		turnNo > log.Size()) {
+		return false;
+	}
+	cancelAI();
+
+	std::vector<uint8_t> cells(log.Cells());
+	log.BoardAt(turnNo, cells.data());
+	std::string state(cells.size(), '0');
+	for (size_t i = 0; i < cells.size(); i++) {
+		state[i] = (char)('0' + cells[i]);
+	}
+	setStateString(state);
+
+	// redo would need the bits of the dropped turns, which were never put on this board
+	_moveLog = log;
+	_moveLog.Truncate(turnNo);
+	recycleUndoneBits();
+	_gameOptions.currentTurnNo = turnNo;
+	markStateChanged();
+	updateResult();
+	return true;
 }
 
 void Game::scanForMouse()
 {
+    PROFILE_ZONE("Game::scanForMouse");
+
     if (gameHasAI() && getCurrentPlayer()->isAIPlayer())
     {
-        updateAI();
+        // the AI only plays at the end of the history, an earlier turn is just being looked at
+        if (!viewingHistory()) {
+            updateAI();
+        }
         return;
     }
 
@@ -103,22 +398,58 @@ void Game::scanForMouse()
     mousePos.x -= ImGui::GetWindowPos().x;
     mousePos.y -= ImGui::GetWindowPos().y;
 
-    for (int y=0; y<_gameOptions.rowY; y++) {
-        for (int x=0; x<_gameOptions.rowX; x++) {
-			BitHolder &holder = getHolderAt(x, y);
-            if (holder.isMouseOver(mousePos)) {
-                if (ImGui::IsMouseClicked(0)) {
-                    if (actionForEmptyHolder(&holder)) {
-                        endTurn();
-                    }
-                } else {
-                    holder.setHighlighted(true);
-                }
-            } else {
-                holder.setHighlighted(false);
-            }
+    BitHolder *holder = holderAtPosition(mousePos);
+    if (holder != _hoveredHolder) {
+        if (_hoveredHolder) {
+            _hoveredHolder->setHighlighted(false);
         }
-    }    
+        if (holder) {
+            holder->setHighlighted(true);
+        }
+        _hoveredHolder = holder;
+    }
+
+    if (holder && ImGui::IsMouseClicked(0)) {
+        if (actionForEmptyHolder(holder)) {
+            endTurn(holder);
+        }
+    }
+}
+
+void Game::setBoardGeometry(const ImVec2 &origin, const ImVec2 &cellSize)
+{
+	_boardOrigin = origin;
+	_cellSize = cellSize;
+	if (_hoveredHolder) {
+		_hoveredHolder->setHighlighted(false);
+	}
+	_hoveredHolder = nullptr;
+}
+
+BitHolder* Game::holderAtPosition(const ImVec2 &position)
+{
+	// games that never set their geometry fall back to testing every holder
+	if (_cellSize.x <= 0.0f || _cellSize.y <= 0.0f) {
+		for (int y=0; y<_gameOptions.rowY; y++) {
+			for (int x=0; x<_gameOptions.rowX; x++) {
+				BitHolder &holder = getHolderAt(x, y);
+				if (holder.isMouseOver(position)) {
+					return &holder;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	const float cellX = (position.x - _boardOrigin.x) / _cellSize.x;
+	const float cellY = (position.y - _boardOrigin.y) / _cellSize.y;
+	if (cellX < 0.0f || cellY < 0.0f || cellX >= (float)_gameOptions.rowX || cellY >= (float)_gameOptions.rowY) {
+		return nullptr;
+	}
+
+	// the holder's sprite may not fill its whole cell
+	BitHolder &holder = getHolderAt((int)cellX, (int)cellY);
+	return holder.isMouseOver(position) ? &holder : nullptr;
 }
 
 //
@@ -127,8 +458,14 @@ void Game::scanForMouse()
 //
 void Game::drawFrame()
 {
+    PROFILE_ZONE("Game::drawFrame");
+
     scanForMouse();
 
+    if (_retainedDraw && _drawCache.Draw(*this)) {
+        return;
+    }
+
     for (int y=0; y<_gameOptions.rowY; y++) {
         for (int x=0; x<_gameOptions.rowX; x++) {
 			BitHolder &holder = getHolderAt(x, y);
@@ -140,9 +477,48 @@ void Game::drawFrame()
     }
 }
 
+void Game::drawTile(const ImVec2 &min, const ImVec2 &size)
+{
+    PROFILE_ZONE("Game::drawTile");
+
+    // the board's extent in its own coordinates (see setBoardGeometry), scaled down to the tile
+    const ImVec2 board(_cellSize.x * _gameOptions.rowX, _cellSize.y * _gameOptions.rowY);
+    if (board.x <= 0.0f || board.y <= 0.0f) {
+        return;
+    }
+    const float scale = std::min(size.x / board.x, size.y / board.y);
+    const ImVec2 origin(min.x + (size.x - board.x * scale) * 0.5f - _boardOrigin.x * scale,
+                        min.y + (size.y - board.y * scale) * 0.5f - _boardOrigin.y * scale);
+
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    if (_retainedDraw && _drawCache.Draw(*this, drawList, origin, scale)) {
+        return;
+    }
+
+    const auto paint = [&](Sprite &sprite) {
+        sprite.updateTexture();
+        if (sprite.textureLoading() || !sprite.getTexture()) {
+            return;
+        }
+        const ImVec2 spriteMin(origin.x + sprite.getPosition().x * scale, origin.y + sprite.getPosition().y * scale);
+        const ImVec2 spriteMax(spriteMin.x + sprite.getSize().x * scale, spriteMin.y + sprite.getSize().y * scale);
+        drawList->AddImage(sprite.getTexture(), spriteMin, spriteMax, sprite.getUV0(), sprite.getUV1(),
+                           ImGui::GetColorU32(sprite.getColor()));
+    };
+    for (int y=0; y<_gameOptions.rowY; y++) {
+        for (int x=0; x<_gameOptions.rowX; x++) {
+			BitHolder &holder = getHolderAt(x, y);
+            paint(holder);
+            if (holder.bit()) {
+                paint(*holder.bit());
+            }
+        }
+    }
+}
+
 void Game::bitMovedFromTo(Bit *bit, BitHolder *src, BitHolder *dst)
 {
-	endTurn();
+	endTurn(dst, src);
 }
 
 Bit* Game::bitToPlaceInHolder(BitHolder *holder)
@@ -174,3 +550,7 @@ void Game::updateAI()
 {
 }
 
+void Game::cancelAI()
+{
+}
+
@@ -5,11 +5,28 @@
 #include <string>
 
 #include "Player.h"
-#include "Turn.h"
 #include "Bit.h"
 #include "BitHolder.h"
+#include "BoardDrawCache.hpp"
+#include "MoveLog.hpp"
+#include "GameArchive.hpp"
 
 class GameTable;
+class Game;
+
+// told about what happens in a game. a game with no listeners depends on nothing outside itself, so any number of
+// them can run at once, on any thread
+class GameListener
+{
+public:
+	virtual ~GameListener() {}
+	// called at the end of every turn, once the turn's move is in the game's move log
+	virtual void	turnEnded(Game &game) = 0;
+	// called after turnEnded() when that turn finished the game. the result is the one the game worked out for the
+	// turn (see Game::winner() and Game::isDraw()), listeners don't need to check the board again
+	virtual void	gameWon(Game &game, Player &winner) {}
+	virtual void	gameDrawn(Game &game) {}
+};
 
 struct GameOptions
 {
@@ -30,7 +47,7 @@ class Game
 {
 public:
 	Game();
-	~Game();
+	virtual ~Game();
 
 	void		startGame();
 
@@ -38,9 +55,34 @@ public:
 
 	// draw the current frame
 	void	drawFrame();
-
-	// end the current game turn
-	void	endTurn();
+	// draw the board scaled to fit the screen rectangle at min, centred in it, e.g. as one tile of many boards in a
+	// window. only draws: the mouse is ignored and nothing is laid out in the window
+	void	drawTile(const ImVec2 &min, const ImVec2 &size);
+	// retained drawing keeps the board's vertices between frames and only rebuilds cells that changed (on by default)
+	bool	retainedDraw() const { return _retainedDraw; };
+	void	setRetainedDraw(bool retained) { _retainedDraw = retained; _drawCache.Invalidate(); };
+
+	// end the current game turn. dst is the holder the turn's bit ended up in (and src the one it came from, for moves);
+	// only that move is recorded, in moveLog()
+	void	endTurn(BitHolder *dst = nullptr, BitHolder *src = nullptr);
+
+	// listeners aren't owned by the game and are called on whichever thread ends the turn
+	void	addListener(GameListener *listener);
+	void	removeListener(GameListener *listener);
+
+	// turn history: undo and redo step one turn, seekToTurn jumps to any turn of this game.
+	// each step applies one turn's move, so seeking costs the number of turns crossed, not a board rebuild per turn.
+	// while looking at an earlier turn the AI waits; a new move from there drops the turns after it
+	bool	canUndo() const { return _gameOptions.currentTurnNo > 0; };
+	bool	canRedo() const { return _gameOptions.currentTurnNo < _moveLog.Size(); };
+	void	undoTurn();
+	void	redoTurn();
+	void	seekToTurn(unsigned int turnNo);
+	unsigned int	lastTurnNo() const { return (unsigned int)_moveLog.Size(); };
+	bool	viewingHistory() const { return canRedo(); };
+	// put a saved game back: the board at turnNo is set through setStateString() and log becomes this game's history,
+	// so it can still be undone. turns after turnNo are dropped. false if the log doesn't fit this board
+	bool	restoreGame(const MoveLog &log, unsigned int turnNo);
 	
 	// Should return true if it is legal for the given bit to be moved from its current holder.
 	// Default implementation always returns true. 
@@ -68,23 +110,63 @@ public:
 	// it's OK to place a new Bit there; else nil.
 	virtual		Bit*	bitToPlaceInHolder(BitHolder *holder);
 
+	// take a holder's bit off the board and keep it for reuse instead of freeing it
+	void		recycleBit(BitHolder &holder);
+	// a recycled bit owned by the given player (so its texture is already right), or nullptr if there is none.
+	// like a freshly created bit it has no references until it's put in a holder
+	Bit*		reuseBit(Player *owner);
+
 	virtual		Player* checkForWinner() = 0;
 	virtual     bool 	checkForDraw() = 0;
+	// both checks in one look at the board: the winner, or nullptr with isDraw set when the board is full.
+	// the default implementation just calls the two above
+	virtual		Player*	checkForResult(bool &isDraw);
+
+	// the result of the board as it is now, worked out once whenever a turn ends, is undone or redone
+	Player*		winner() const { return _winner; };
+	bool		isDraw() const { return _draw; };
+	bool		gameOver() const { return _winner != nullptr || _draw; };
 	virtual		bool	animateAndPlaceBitFromTo(Bit *bit, BitHolder*src, BitHolder*dst);
 
 	virtual		void	stopGame() = 0;
     virtual     bool    gameHasAI();
     virtual     void    updateAI();
+    // drop an AI move that is still being searched for, the board it was searching changed
+    virtual     void    cancelAI();
 
 	virtual		std::string	initialStateString() = 0;
 	virtual		std::string stateString() const = 0;
 	virtual		void setStateString(const std::string &s) = 0;
+
+	// bumped every time the board changes, so anything derived from the board (like the state string)
+	// can be cached and only rebuilt when the version moves
+	unsigned int	stateVersion() const { return _stateVersion; };
+	void			markStateChanged() { _stateVersion++; };
     
+	// every move of this game, from the board as it was at startGame()
+	const MoveLog&	moveLog() const { return _moveLog; };
+	// this game as GameArchive stores it, winner being the winning player's number or -1 for a draw
+	GameRecord	gameRecord(int winner) const;
+	// the board as moveLog() stores it: one byte per cell, 0 when empty, otherwise the owner's player number + 1
+	void		boardCells(std::vector<uint8_t> &cells);
+
 	void		setNumberOfPlayers(unsigned int playerCount);
 	void		setAIPlayer(unsigned int playerNumber);
+	// whether the AI takes its player's turns, off makes it a game between two people. kept across new games
+	bool		aiEnabled() const { return _aiEnabled; };
+	void		setAIEnabled(bool enabled);
+	// the AI plays every player instead of just the AI player, for watching AI games. kept across new games
+	bool		aiVsAI() const { return _gameOptions.AIvsAI; };
+	void		setAIvsAI(bool enabled);
     void        scanForMouse();
 	// function to return pointer to the [][] array of bitholders
 	virtual BitHolder &getHolderAt(const int x, const int y) = 0;
+
+	// board layout for hit testing: holder (x, y) sits in the cell at origin + (x, y) * cellSize (window coordinates),
+	// so the holder under the mouse is found directly instead of testing every holder
+	void		setBoardGeometry(const ImVec2 &origin, const ImVec2 &cellSize);
+	// the holder under a point in window coordinates, or nullptr
+	BitHolder*	holderAtPosition(const ImVec2 &position);
 	
 	const unsigned int			getCurrentTurnNo() { return _gameOptions.currentTurnNo; };
 	const int					getScore() { return _score; };
@@ -96,13 +178,34 @@ public:
 	Player					*_winner;
 
 	std::vector<Player*>	_players;
-	std::vector<Turn*>		_turns;
 
 	int						_score;
 	std::string				_lastMove;
 
 	GameOptions 			_gameOptions;
 
-	int						_gameNumber;
+private:
+	BitHolder&				holderForCell(uint32_t cell);
+	void					recycleUndoneBits();
+	void					updateResult();
+
+	MoveLog					_moveLog;
+	std::vector<GameListener*>	_listeners;
+	// bits placed by the turns after the current one, lifted off the board by undo; the last one is redone first
+	std::vector<Bit*>		_undoneBits;
+	// bits off the board waiting to be reused, each holding one reference
+	std::vector<Bit*>		_spareBits;
+
+	unsigned int			_stateVersion;
+	bool					_draw;
+
+	ImVec2					_boardOrigin;
+	ImVec2					_cellSize;
+	// the highlighted holder, only changed when the mouse enters or leaves a holder
+	BitHolder				*_hoveredHolder;
+
+	bool					_retainedDraw;
+	bool					_aiEnabled;
+	BoardDrawCache			_drawCache;
 };
 
@@ -0,0 +1,308 @@
+#include "classes/GameArchive.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "classes/Tracer.hpp"
+
+namespace {
+    constexpr char          ARCHIVE_MAGIC[8] = {'T', 'T', 'T', 'G', 'A', 'M', 'E', 'S'};
+    constexpr char          INDEX_MAGIC[8]   = {'T', 'T', 'T', 'I', 'N', 'D', 'E', 'X'};
+    constexpr std::uint32_t VERSION          = 1;
+    constexpr std::size_t   RECORD_ALIGNMENT = 8;
+
+    struct FileHeader {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    struct FileRecord {
+        std::uint32_t size; // the whole record, header and padding included
+        std::uint32_t game_number;
+        std::int64_t  finished_at;
+        std::uint32_t move_count;
+        std::uint32_t move_bytes;
+        std::uint16_t columns;
+        std::uint16_t rows;
+        std::uint8_t  player_count;
+        std::int8_t   winner;
+        std::uint16_t reserved;
+    };
+
+    std::size_t AlignUp(const std::size_t value, const std::size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool HeaderMatches(std::string_view data, const char (&magic)[8]) {
+        if (data.size() < sizeof(FileHeader)) return false;
+        FileHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        return std::memcmp(header.magic, magic, sizeof(header.magic)) == 0 && header.version == VERSION;
+    }
+
+    // opens a file for appending, writing the header first if it's new; size receives the file's length
+    bool OpenForAppend(const std::filesystem::path& path, const char (&magic)[8], std::ofstream& out,
+                       std::uint64_t& size) {
+        std::error_code error;
+        size = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+        if (error) return false;
+
+        out.open(path, std::ios::binary | std::ios::app);
+        if (!out) return false;
+        if (size == 0) {
+            FileHeader header{};
+            std::memcpy(header.magic, magic, sizeof(header.magic));
+            header.version = VERSION;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            size = sizeof(header);
+        }
+        return static_cast<bool>(out);
+    }
+
+    // writes a new index for an archive whose index is gone by walking its records; next_game_number follows the last
+    // one found. Fails on a damaged record before the end, as everything after it could only be guessed at.
+    bool RebuildIndex(const std::filesystem::path& path, const std::filesystem::path& index_path,
+                      std::uint32_t& next_game_number) {
+        MappedFile existing;
+        if (!existing.Open(path) || existing.Size() <= sizeof(FileHeader)) return true; // nothing to index
+        if (!HeaderMatches(existing.View(), ARCHIVE_MAGIC)) return false;
+
+        std::vector<ArchiveIndexEntry> entries;
+        std::uint64_t                  offset = sizeof(FileHeader);
+        while (offset + sizeof(FileRecord) <= existing.Size()) {
+            FileRecord header;
+            std::memcpy(&header, existing.Data() + offset, sizeof(header));
+            // a crash can only have torn the last record
+            if (offset + header.size > existing.Size()) break;
+
+            const std::size_t cells = static_cast<std::size_t>(header.columns) * header.rows;
+            if (header.size % RECORD_ALIGNMENT != 0 ||
+                header.size < sizeof(FileRecord) + header.player_count + cells + header.move_bytes ||
+                (!entries.empty() && header.game_number <= entries.back().game_number)) {
+                return false;
+            }
+
+            ArchiveIndexEntry entry{};
+            entry.game_number = header.game_number;
+            entry.winner      = header.winner;
+            entry.offset      = offset;
+            entries.push_back(entry);
+            offset += header.size;
+        }
+        if (entries.empty()) return true;
+
+        std::ofstream index(index_path, std::ios::binary | std::ios::trunc);
+        FileHeader    header{};
+        std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        index.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        index.write(reinterpret_cast<const char*>(entries.data()),
+                    static_cast<std::streamsize>(entries.size() * sizeof(ArchiveIndexEntry)));
+        if (!index.flush()) return false;
+
+        next_game_number = entries.back().game_number + 1;
+        return true;
+    }
+} // namespace
+
+GameArchive::~GameArchive() {
+    Close();
+}
+
+bool GameArchive::Open(const std::filesystem::path& path) {
+    Close();
+
+    std::filesystem::path index_path = path;
+    index_path += INDEX_EXTENSION;
+
+    // carry on numbering from the last indexed game
+    next_game_number            = 0;
+    std::size_t torn_entries    = 0;
+    std::size_t indexed_entries = 0;
+    {
+        MappedFile existing;
+        if (existing.Open(index_path) && existing.Size() > 0) {
+            if (!HeaderMatches(existing.View(), INDEX_MAGIC)) return false;
+            const std::size_t entries = (existing.Size() - sizeof(FileHeader)) / sizeof(ArchiveIndexEntry);
+            torn_entries              = existing.Size() - sizeof(FileHeader) - entries * sizeof(ArchiveIndexEntry);
+            indexed_entries           = entries;
+            if (entries > 0) {
+                ArchiveIndexEntry last;
+                std::memcpy(&last, existing.Data() + sizeof(FileHeader) + (entries - 1) * sizeof(ArchiveIndexEntry),
+                            sizeof(last));
+                next_game_number = last.game_number + 1;
+            }
+        }
+    }
+    // an entry cut short by a crash would shift every entry after it
+    if (torn_entries > 0) {
+        std::error_code error;
+        std::filesystem::resize_file(index_path, std::filesystem::file_size(index_path, error) - torn_entries, error);
+        if (error) return false;
+    }
+    // without its index an archive would number new games from 0 again, reusing the numbers of the games in it
+    if (indexed_entries == 0 && !RebuildIndex(path, index_path, next_game_number)) return false;
+
+    std::uint64_t index_size = 0;
+    if (!OpenForAppend(path, ARCHIVE_MAGIC, archive, archive_size) ||
+        !OpenForAppend(index_path, INDEX_MAGIC, index, index_size)) {
+        archive.close();
+        index.close();
+        return false;
+    }
+    // a record torn by a crash leaves the size unaligned, keep the next one aligned anyway
+    const std::size_t padding = AlignUp(archive_size, RECORD_ALIGNMENT) - archive_size;
+    if (padding > 0) {
+        const char zeros[RECORD_ALIGNMENT] = {};
+        archive.write(zeros, static_cast<std::streamsize>(padding));
+        archive_size += padding;
+    }
+
+    stopping = false;
+    writer   = std::thread(&GameArchive::WriterLoop, this);
+    return true;
+}
+
+void GameArchive::Close() {
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    writer.join();
+    archive.close();
+    index.close();
+}
+
+std::uint32_t GameArchive::Append(const GameRecord& record) {
+    PendingGame pending;
+
+    FileRecord header{};
+    header.finished_at  = record.finished_at;
+    header.move_count   = record.move_count;
+    header.move_bytes   = static_cast<std::uint32_t>(record.moves.size());
+    header.columns      = record.columns;
+    header.rows         = record.rows;
+    header.player_count = static_cast<std::uint8_t>(record.players.size());
+    header.winner       = record.winner;
+    header.size         = static_cast<std::uint32_t>(AlignUp(
+        sizeof(FileRecord) + record.players.size() + record.start_board.size() + record.moves.size(), RECORD_ALIGNMENT));
+
+    pending.bytes.resize(header.size);
+    std::uint8_t* out = pending.bytes.data() + sizeof(FileRecord);
+    out               = std::copy(record.players.begin(), record.players.end(), out);
+    out               = std::copy(record.start_board.begin(), record.start_board.end(), out);
+    std::copy(record.moves.begin(), record.moves.end(), out);
+
+    pending.entry        = ArchiveIndexEntry{};
+    pending.entry.winner = record.winner;
+
+    std::uint32_t game_number;
+    {
+        std::lock_guard lock(mutex);
+        game_number               = next_game_number++;
+        header.game_number        = game_number;
+        pending.entry.game_number = game_number;
+        std::memcpy(pending.bytes.data(), &header, sizeof(header));
+        queue.push_back(std::move(pending));
+    }
+    wake.notify_one();
+    return game_number;
+}
+
+void GameArchive::WriterLoop() {
+    Tracer::GetInstance().SetThreadName("archive writer");
+
+    std::deque<PendingGame>        batch;
+    std::vector<ArchiveIndexEntry> entries;
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // stopping, and everything is written
+            batch.swap(queue);
+        }
+
+        TRACE_SCOPE("GameArchive write");
+        entries.clear();
+        for (PendingGame& game : batch) {
+            game.entry.offset = archive_size;
+            archive.write(reinterpret_cast<const char*>(game.bytes.data()), static_cast<std::streamsize>(game.bytes.size()));
+            archive_size += game.bytes.size();
+            entries.push_back(game.entry);
+        }
+        batch.clear();
+
+        // records first, so an index entry never points past what reached the file
+        archive.flush();
+        if (!archive) continue; // nothing more can be archived, keep draining so Close() still returns
+        index.write(reinterpret_cast<const char*>(entries.data()),
+                    static_cast<std::streamsize>(entries.size() * sizeof(ArchiveIndexEntry)));
+        index.flush();
+    }
+}
+
+bool GameArchiveReader::Open(const std::filesystem::path& path) {
+    std::filesystem::path index_path = path;
+    index_path += GameArchive::INDEX_EXTENSION;
+
+    if (!archive.Open(path) || !index.Open(index_path) || !HeaderMatches(archive.View(), ARCHIVE_MAGIC) ||
+        !HeaderMatches(index.View(), INDEX_MAGIC)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void GameArchiveReader::Close() {
+    archive.Close();
+    index.Close();
+}
+
+std::span<const ArchiveIndexEntry> GameArchiveReader::Index() const {
+    if (index.Size() < sizeof(FileHeader)) return {};
+    // the header keeps the entries 8-byte aligned within the page-aligned mapping
+    return {reinterpret_cast<const ArchiveIndexEntry*>(index.Data() + sizeof(FileHeader)),
+            (index.Size() - sizeof(FileHeader)) / sizeof(ArchiveIndexEntry)};
+}
+
+bool GameArchiveReader::Read(const std::size_t position, GameRecordView& game) const {
+    const std::span<const ArchiveIndexEntry> entries = Index();
+    if (position >= entries.size()) return false;
+
+    const std::uint64_t offset = entries[position].offset;
+    if (offset < sizeof(FileHeader) || offset + sizeof(FileRecord) > archive.Size()) return false;
+    FileRecord header;
+    std::memcpy(&header, archive.Data() + offset, sizeof(header));
+
+    const std::size_t cells = static_cast<std::size_t>(header.columns) * header.rows;
+    if (header.size < sizeof(FileRecord) + header.player_count + cells + header.move_bytes ||
+        offset + header.size > archive.Size()) {
+        return false;
+    }
+
+    const auto* data  = reinterpret_cast<const std::uint8_t*>(archive.Data() + offset + sizeof(FileRecord));
+    game.game_number  = header.game_number;
+    game.finished_at  = header.finished_at;
+    game.winner       = header.winner;
+    game.columns      = header.columns;
+    game.rows         = header.rows;
+    game.move_count   = header.move_count;
+    game.players      = {data, header.player_count};
+    game.start_board  = {data + header.player_count, cells};
+    game.moves        = {data + header.player_count + cells, header.move_bytes};
+    return true;
+}
+
+std::size_t GameArchiveReader::Find(const std::uint32_t game_number) const {
+    // game numbers only ever go up through the index
+    const std::span<const ArchiveIndexEntry> entries = Index();
+    const auto found = std::lower_bound(entries.begin(), entries.end(), game_number,
+                                        [](const ArchiveIndexEntry& entry, const std::uint32_t number) {
+                                            return entry.game_number < number;
+                                        });
+    if (found == entries.end() || found->game_number != game_number) return entries.size();
+    return static_cast<std::size_t>(found - entries.begin());
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "classes/MappedFile.hpp"
+
+/**
+ * @brief A finished game, as handed to GameArchive::Append()
+ */
+struct GameRecord {
+    std::int64_t              finished_at = 0;  // seconds since the Unix epoch
+    std::int8_t               winner      = -1; // player number, or -1 for a draw
+    std::uint16_t             columns     = 0;
+    std::uint16_t             rows        = 0;
+    std::vector<std::uint8_t> players;          // one byte per player, GameArchive::PLAYER_AI when the AI played it
+    std::vector<std::uint8_t> start_board;      // columns * rows cells, as MoveLog stores them
+    std::uint32_t             move_count = 0;
+    std::vector<std::uint8_t> moves;            // MoveLog::Encoded()
+};
+
+/**
+ * @brief One archived game, pointing straight into the mapped archive
+ */
+struct GameRecordView {
+    std::uint32_t                 game_number = 0;
+    std::int64_t                  finished_at = 0;
+    std::int8_t                   winner      = -1;
+    std::uint16_t                 columns     = 0;
+    std::uint16_t                 rows        = 0;
+    std::uint32_t                 move_count  = 0;
+    std::span<const std::uint8_t> players;
+    std::span<const std::uint8_t> start_board;
+    std::span<const std::uint8_t> moves; // decode with MoveLog::DecodeMove()
+};
+
+/**
+ * @brief Entry of the sidecar index: where a game's record starts in the archive
+ */
+struct ArchiveIndexEntry {
+    std::uint32_t game_number;
+    std::int8_t   winner;
+    std::uint8_t  reserved[3];
+    std::uint64_t offset;
+};
+
+/**
+ * @brief Append-only store of finished games, written on a background thread.
+ *
+ * The archive is a small header followed by one record per game: a fixed record header, a byte per player, the
+ * starting board and the MoveLog encoded moves, padded to 8 bytes. The index next to it (the archive's path plus
+ * INDEX_EXTENSION) holds a fixed-size ArchiveIndexEntry per game. An entry is only written once its record has been
+ * flushed, so the index never points at a torn record; a record left half written by a crash is never indexed and
+ * later records simply follow it.
+ *
+ * Append() only serializes the game into memory and queues it, the files are written by the archive's own thread.
+ * Game numbers count up from the last one in the index.
+ */
+class GameArchive {
+public:
+    static constexpr std::uint8_t PLAYER_AI       = 1;
+    static constexpr const char*  INDEX_EXTENSION = ".idx";
+
+    static GameArchive& GetInstance() {
+        static GameArchive instance;
+        return instance;
+    }
+
+    GameArchive(const GameArchive&)            = delete;
+    GameArchive& operator=(const GameArchive&) = delete;
+
+    /**
+     * @brief Open an archive for appending, creating it and its index if needed
+     * @return true if both files could be opened
+     */
+    bool Open(const std::filesystem::path& path);
+    /**
+     * @brief Write everything still queued and close the files
+     */
+    void Close();
+    inline bool IsOpen() const { return writer.joinable(); };
+
+    /**
+     * @brief Queue a finished game to be written. Never waits for the disk.
+     * @return The number the game is archived under
+     */
+    std::uint32_t Append(const GameRecord& record);
+
+private:
+    GameArchive() = default;
+    ~GameArchive();
+
+    void WriterLoop();
+
+    struct PendingGame {
+        std::vector<std::uint8_t> bytes;
+        ArchiveIndexEntry         entry;
+    };
+
+    std::mutex              mutex;
+    std::condition_variable wake;
+    std::deque<PendingGame> queue;
+    bool                    stopping = false;
+    std::thread             writer;
+
+    // only touched by the writer thread while it runs
+    std::ofstream archive;
+    std::ofstream index;
+    std::uint64_t archive_size = 0;
+
+    std::uint32_t next_game_number = 0;
+};
+
+/**
+ * @brief Reads an archive through memory mappings, without copying any record.
+ *
+ * The archive and the index are mapped as they were when Open() was called; games appended afterwards are only seen
+ * after opening again.
+ */
+class GameArchiveReader {
+public:
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    inline std::size_t                        Count() const { return Index().size(); };
+    std::span<const ArchiveIndexEntry>        Index() const;
+    /**
+     * @brief Look up a game by its position in the index
+     * @return false if the record is missing or damaged
+     */
+    bool Read(std::size_t position, GameRecordView& game) const;
+    /**
+     * @brief Position of a game in the index, or Count() if it isn't there
+     */
+    std::size_t Find(std::uint32_t game_number) const;
+
+private:
+    MappedFile archive;
+    MappedFile index;
+};
@@ -0,0 +1,163 @@
+#include "classes/GameSettings.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Application.h"
+#include "classes/Autosave.hpp"
+#include "classes/Game.h"
+#include "imgui/imgui.h"
+#include "imgui/imgui_internal.h"
+
+namespace {
+    constexpr const char* TYPE_NAME    = "TicTacToe";
+    constexpr const char* SECTION_NAME = "Game";
+
+    // one character per cell, as in the state strings
+    void AppendCells(ImGuiTextBuffer* buf, const std::vector<std::uint8_t>& cells) {
+        for (const std::uint8_t cell : cells) buf->appendf("%c", static_cast<char>('0' + cell));
+    }
+
+    // "4,0,8": a placement is its cell, a moved bit "from>to" and a turn that changed nothing "-"
+    void AppendMoves(ImGuiTextBuffer* buf, const MoveLog& log) {
+        for (std::size_t i = 0; i < log.Size(); i++) {
+            const MoveLog::Move move = log.MoveAt(i);
+            if (i > 0) buf->append(",");
+            if (move.to == MoveLog::NO_CELL) buf->append("-");
+            else if (move.from == MoveLog::NO_CELL) buf->appendf("%u", move.to);
+            else buf->appendf("%u>%u", move.from, move.to);
+        }
+    }
+
+    bool ParseMoves(const std::string& text, MoveLog& log) {
+        const char* cursor = text.c_str();
+        while (*cursor != '\0') {
+            MoveLog::Move move;
+            if (*cursor == '-') {
+                cursor++;
+            }
+            else {
+                char* end = nullptr;
+                move.to   = static_cast<std::uint32_t>(std::strtoul(cursor, &end, 10));
+                if (end == cursor) return false;
+                cursor = end;
+                if (*cursor == '>') {
+                    move.from = move.to;
+                    move.to   = static_cast<std::uint32_t>(std::strtoul(cursor + 1, &end, 10));
+                    if (end == cursor + 1) return false;
+                    cursor = end;
+                }
+                if (move.to >= log.Cells() || (move.from != MoveLog::NO_CELL && move.from >= log.Cells())) return false;
+            }
+            log.Append(move);
+            if (*cursor == ',') cursor++;
+            else if (*cursor != '\0') return false;
+        }
+        return true;
+    }
+} // namespace
+
+void GameSettings::Register() {
+    ImGuiSettingsHandler handler;
+    handler.TypeName   = TYPE_NAME;
+    handler.TypeHash   = ImHashStr(TYPE_NAME);
+    handler.ClearAllFn = ClearAll;
+    handler.ReadOpenFn = ReadOpen;
+    handler.ReadLineFn = ReadLine;
+    handler.ApplyAllFn = ApplyAll;
+    handler.WriteAllFn = WriteAll;
+    handler.UserData   = this;
+    ImGui::AddSettingsHandler(&handler);
+}
+
+void GameSettings::MarkDirty() {
+    if (ImGui::GetCurrentContext()) ImGui::MarkIniSettingsDirty();
+}
+
+void GameSettings::ClearAll(ImGuiContext*, ImGuiSettingsHandler* handler) {
+    static_cast<GameSettings*>(handler->UserData)->saved = SavedGame{};
+}
+
+void* GameSettings::ReadOpen(ImGuiContext*, ImGuiSettingsHandler* handler, const char* name) {
+    if (std::strcmp(name, SECTION_NAME) != 0) return nullptr;
+    SavedGame& saved = static_cast<GameSettings*>(handler->UserData)->saved;
+    saved            = SavedGame{};
+    saved.present    = true;
+    return &saved;
+}
+
+void GameSettings::ReadLine(ImGuiContext*, ImGuiSettingsHandler*, void* entry, const char* line) {
+    SavedGame& saved = *static_cast<SavedGame*>(entry);
+    int          ai;
+    unsigned int turn;
+    if (std::sscanf(line, "AI=%d", &ai) == 1) saved.ai_enabled = ai != 0 ? 1 : 0;
+    else if (std::sscanf(line, "Turn=%u", &turn) == 1) saved.turn = turn;
+    else if (std::strncmp(line, "Start=", 6) == 0) saved.start = line + 6;
+    else if (std::strncmp(line, "Moves=", 6) == 0) saved.moves = line + 6;
+    else if (std::strncmp(line, "Board=", 6) == 0) saved.board = line + 6;
+}
+
+void GameSettings::ApplyAll(ImGuiContext*, ImGuiSettingsHandler* handler) {
+    SavedGame& saved = static_cast<GameSettings*>(handler->UserData)->saved;
+    Game*      game  = ClassGame::CurrentGame();
+    if (!saved.present || !game) return;
+
+    if (saved.ai_enabled >= 0) game->setAIEnabled(saved.ai_enabled != 0);
+
+    // only a game nobody has played yet is replaced
+    if (game->lastTurnNo() != 0 || saved.start.size() != game->moveLog().Cells()) return;
+    std::vector<std::uint8_t> start(saved.start.size());
+    for (std::size_t i = 0; i < start.size(); i++) {
+        if (saved.start[i] < '0' || saved.start[i] > '9') return;
+        start[i] = static_cast<std::uint8_t>(saved.start[i] - '0');
+    }
+    MoveLog log;
+    log.Reset(start.size(), game->moveLog().Players(), start.data());
+    if (!ParseMoves(saved.moves, log) || saved.turn > log.Size()) return;
+
+    // a hand edited section that no longer adds up is left alone
+    std::vector<std::uint8_t> cells(log.Cells());
+    log.BoardAt(saved.turn, cells.data());
+    for (std::size_t i = 0; i < cells.size() && !saved.board.empty(); i++) {
+        if (i >= saved.board.size() || saved.board[i] != static_cast<char>('0' + cells[i])) return;
+    }
+    if (game->restoreGame(log, saved.turn)) {
+        ClassGame::RefreshGameOver();
+        Autosave::GetInstance().Snapshot(game->moveLog(), game->getCurrentTurnNo());
+    }
+    saved = SavedGame{};
+}
+
+void GameSettings::Detach() {
+    Game* game = ClassGame::CurrentGame();
+    if (!game) return;
+    ImGuiTextBuffer buf;
+    WriteGame(*game, &buf);
+    detached.assign(buf.c_str(), static_cast<std::size_t>(buf.size()));
+}
+
+void GameSettings::WriteAll(ImGuiContext*, ImGuiSettingsHandler* handler, ImGuiTextBuffer* buf) {
+    Game* game = ClassGame::CurrentGame();
+    if (game) WriteGame(*game, buf);
+    else buf->append(static_cast<GameSettings*>(handler->UserData)->detached.c_str());
+}
+
+void GameSettings::WriteGame(Game& game, ImGuiTextBuffer* buf) {
+    const MoveLog& log = game.moveLog();
+
+    std::vector<std::uint8_t> cells(log.Cells());
+    buf->appendf("[%s][%s]\n", TYPE_NAME, SECTION_NAME);
+    buf->appendf("AI=%d\n", game.aiEnabled() ? 1 : 0);
+    buf->append("Start=");
+    log.BoardAt(0, cells.data());
+    AppendCells(buf, cells);
+    buf->append("\nMoves=");
+    AppendMoves(buf, log);
+    buf->appendf("\nTurn=%u\n", game.getCurrentTurnNo());
+    buf->append("Board=");
+    log.BoardAt(game.getCurrentTurnNo(), cells.data());
+    AppendCells(buf, cells);
+    buf->append("\n\n");
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+
+class Game;
+struct ImGuiContext;
+struct ImGuiSettingsHandler;
+struct ImGuiTextBuffer;
+
+/**
+ * @brief Keeps the game in imgui.ini, next to the window layout.
+ *
+ * A [TicTacToe][Game] section holds the AI setting, the board at the start of the game, its moves (as MoveLog cells),
+ * the turn being shown and the board at that turn. ImGui reads it with the rest of the file on the first frame and
+ * writes it whenever it saves the file, so no file is written here. MarkDirty() only arms ImGui's save timer
+ * (io.IniSavingRate), so any number of turns within one interval cost a single save.
+ *
+ * The saved game is only put back on a game that hasn't started yet, a game restored by the autosave is newer.
+ */
+class GameSettings {
+public:
+    static GameSettings& GetInstance() {
+        static GameSettings instance;
+        return instance;
+    }
+
+    GameSettings(const GameSettings&)            = delete;
+    GameSettings& operator=(const GameSettings&) = delete;
+
+    /**
+     * @brief Add the settings handler to the current ImGui context; the ini file is loaded on the first NewFrame()
+     */
+    void Register();
+    /**
+     * @brief The game changed, have ImGui save the ini file once its save timer runs out
+     */
+    void MarkDirty();
+    /**
+     * @brief Keep the game's section as it is now, for the save ImGui makes in DestroyContext() after the game is gone
+     */
+    void Detach();
+
+private:
+    GameSettings() = default;
+
+    static void  ClearAll(ImGuiContext* ctx, ImGuiSettingsHandler* handler);
+    static void* ReadOpen(ImGuiContext* ctx, ImGuiSettingsHandler* handler, const char* name);
+    static void  ReadLine(ImGuiContext* ctx, ImGuiSettingsHandler* handler, void* entry, const char* line);
+    static void  ApplyAll(ImGuiContext* ctx, ImGuiSettingsHandler* handler);
+    static void  WriteAll(ImGuiContext* ctx, ImGuiSettingsHandler* handler, ImGuiTextBuffer* buf);
+    static void  WriteGame(Game& game, ImGuiTextBuffer* buf);
+
+    // the section as read, until it's applied
+    struct SavedGame {
+        bool         present    = false;
+        int          ai_enabled = -1; // -1 when the line is missing
+        std::string  start;
+        std::string  moves;
+        std::string  board;
+        unsigned int turn = 0;
+    };
+    SavedGame   saved;
+    std::string detached; // written instead of the game once Detach() has been called
+};
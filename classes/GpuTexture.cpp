@@ -0,0 +1,132 @@
+#ifdef DEMO_USE_GLAD_FOR_GL
+#include <glad/gl.h>
+#endif
+
+#include "GpuTexture.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+static std::atomic<int> liveTextures{0};
+
+int GpuTexture::LiveCount()
+{
+    return liveTextures.load(std::memory_order_relaxed);
+}
+
+#if defined(DEMO_HEADLESS)
+// No GPU: hand out unique ids so texture ownership and the live count behave as they do with a real backend
+
+static std::atomic<std::intptr_t> nextTexture{1};
+
+ImTextureID GpuTexture::Create(const unsigned char *image_data, int image_width, int image_height)
+{
+    liveTextures++;
+    return static_cast<ImTextureID>(nextTexture++);
+}
+
+void GpuTexture::Destroy(ImTextureID texture)
+{
+    if (texture != 0) {
+        liveTextures--;
+    }
+}
+#elif defined(WIN32)
+// DirectX
+#include <stdio.h>
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "d3dcompiler") // Automatically link with d3dcompiler.lib as we are using D3DCompile() below.
+#endif
+
+ImTextureID GpuTexture::Create(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create texture
+    D3D11_TEXTURE2D_DESC desc;
+    ZeroMemory(&desc, sizeof(desc));
+    desc.Width = image_width;
+    desc.Height = image_height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = 0;
+
+    ID3D11Texture2D *pTexture = NULL;
+    D3D11_SUBRESOURCE_DATA subResource;
+    subResource.pSysMem = image_data;
+    subResource.SysMemPitch = desc.Width * 4;
+    subResource.SysMemSlicePitch = 0;
+
+    // You need to have a valid ID3D11Device* available as g_pd3dDevice
+    extern ID3D11Device* g_pd3dDevice; // Add this line if g_pd3dDevice is defined elsewhere
+
+    HRESULT hr = g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
+    if (FAILED(hr) || !pTexture) {
+        return 0;
+    }
+
+    // Create texture view
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+    ZeroMemory(&srvDesc, sizeof(srvDesc));
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = desc.MipLevels;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+
+    ID3D11ShaderResourceView* shaderResourceView = nullptr;
+    hr = g_pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &shaderResourceView);
+    pTexture->Release();
+
+    if (FAILED(hr) || !shaderResourceView) {
+
+        return 0;
+    }
+    liveTextures++;
+    return reinterpret_cast<ImTextureID>(shaderResourceView);
+}
+
+void GpuTexture::Destroy(ImTextureID texture)
+{
+    if (texture == 0) {
+        return;
+    }
+    // the view holds the last reference to the texture itself
+    reinterpret_cast<ID3D11ShaderResourceView*>(texture)->Release();
+    liveTextures--;
+}
+#else
+
+ImTextureID GpuTexture::Create(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create a OpenGL texture identifier
+    GLuint image_texture;
+    glGenTextures(1, &image_texture);
+    glBindTexture(GL_TEXTURE_2D, image_texture);
+
+    // Setup filtering parameters for display
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Upload pixels into texture
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
+
+    liveTextures++;
+    return static_cast<ImTextureID>(image_texture);
+}
+
+void GpuTexture::Destroy(ImTextureID texture)
+{
+    if (texture == 0) {
+        return;
+    }
+    GLuint image_texture = static_cast<GLuint>(texture);
+    glDeleteTextures(1, &image_texture);
+    liveTextures--;
+}
+
+#endif
+
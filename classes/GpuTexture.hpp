@@ -0,0 +1,22 @@
+#pragma once
+
+#include "imgui/imgui.h"
+
+/**
+ * @brief Platform specific texture creation (OpenGL, Direct3D 11 on Windows, or no GPU at all with DEMO_HEADLESS)
+ */
+namespace GpuTexture {
+    /**
+     * @brief Upload RGBA8 pixels to a new texture with linear filtering
+     * @return The texture, or 0 on failure
+     */
+    ImTextureID Create(const unsigned char* rgba, int width, int height);
+
+    /**
+     * @brief Free a texture made by Create(). Needs the rendering context to be current.
+     */
+    void Destroy(ImTextureID texture);
+
+    /// Textures created and not destroyed yet; should drop back to zero at shutdown.
+    int LiveCount();
+} // namespace GpuTexture
@@ -0,0 +1,333 @@
+#include "classes/LogViewer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "imgui/imgui.h"
+
+/// Bytes the index thread scans between publishing new lines to the UI.
+static constexpr std::size_t INDEX_PUBLISH_BYTES = 4 << 20;
+
+/// Lines longer than this are cut short when drawn (they are still searched in full).
+static constexpr std::size_t MAX_DISPLAY_LINE = 4096;
+
+/**
+ * @brief Find the level of a line written by Logger ("[time] [LEVEL] ...")
+ * @return The level index, or Info for lines that don't follow the format
+ */
+static int LineLevel(const std::string_view line) {
+    const std::size_t open = line.find("] [");
+    if (open == std::string_view::npos) return static_cast<int>(LogLevel::Info);
+
+    const std::string_view level = line.substr(open + 3, 5);
+    if (level.starts_with("WARN")) return static_cast<int>(LogLevel::Warn);
+    if (level.starts_with("ERROR")) return static_cast<int>(LogLevel::Error);
+    return static_cast<int>(LogLevel::Info);
+}
+
+bool LogViewer::Filter::Matches(const std::string_view line) const {
+    if (!levels[LineLevel(line)]) return false;
+    return text.empty() || line.find(text) != std::string_view::npos;
+}
+
+LogViewer::~LogViewer() {
+    Close();
+}
+
+bool LogViewer::Open(const std::filesystem::path& file_path) {
+    Close();
+
+    if (!file.Open(file_path)) {
+        Logger::GetInstance().LogWarn("Could not map log file \"{}\"", file_path.string());
+        return false;
+    }
+    path = file_path;
+
+    index_stop   = false;
+    index_done   = false;
+    index_thread = std::thread(&LogViewer::IndexWorker, this);
+
+    if (active_filter.IsActive()) StartFilter();
+    return true;
+}
+
+void LogViewer::Close() {
+    StopFilter();
+    StopIndex();
+    file.Close();
+
+    block_offsets.clear();
+    block_offsets.shrink_to_fit();
+    line_count = 0;
+    match_prefix.assign(1, 0);
+}
+
+void LogViewer::StopIndex() {
+    if (!index_thread.joinable()) return;
+    index_stop = true;
+    index_thread.join();
+}
+
+void LogViewer::StopFilter() {
+    if (!filter_thread.joinable()) return;
+    {
+        // take the lock so a filter thread waiting on new lines can't miss the wakeup
+        std::lock_guard lock(index_mutex);
+        filter_stop = true;
+    }
+    index_cv.notify_all();
+    filter_thread.join();
+}
+
+void LogViewer::StartFilter() {
+    StopFilter();
+    {
+        std::lock_guard lock(filter_mutex);
+        match_prefix.assign(1, 0);
+    }
+    filter_stop = false;
+    filter_done = false;
+    if (file.IsOpen() && active_filter.IsActive()) {
+        filter_thread = std::thread(&LogViewer::FilterWorker, this, active_filter);
+    }
+}
+
+//
+// scan the mapped file for line starts, recording the first line of every block
+//
+void LogViewer::IndexWorker() {
+    const char*       data = file.Data();
+    const std::size_t size = file.Size();
+
+    std::vector<std::uint64_t> pending;
+    std::size_t                lines = 0;
+    if (size > 0) {
+        pending.push_back(0);
+        lines = 1;
+    }
+
+    const auto publish = [&](const bool done) {
+        {
+            std::lock_guard lock(index_mutex);
+            block_offsets.insert(block_offsets.end(), pending.begin(), pending.end());
+            line_count = lines;
+            index_done = done;
+        }
+        pending.clear();
+        index_cv.notify_all();
+    };
+
+    std::size_t pos          = 0;
+    std::size_t next_publish = INDEX_PUBLISH_BYTES;
+    while (pos < size && !index_stop) {
+        const void* newline = std::memchr(data + pos, '\n', size - pos);
+        if (!newline) break;
+
+        pos = static_cast<std::size_t>(static_cast<const char*>(newline) - data) + 1;
+        if (pos < size) {
+            if (lines % LINES_PER_BLOCK == 0) pending.push_back(pos);
+            lines++;
+        }
+
+        if (pos >= next_publish) {
+            publish(false);
+            next_publish = pos + INDEX_PUBLISH_BYTES;
+        }
+    }
+
+    publish(true);
+}
+
+//
+// count the matching lines of each block as soon as the block has been fully indexed
+//
+void LogViewer::FilterWorker(const Filter filter) {
+    std::uint64_t matches = 0;
+    for (std::size_t block = 0;; block++) {
+        std::size_t   lines;
+        std::uint64_t offset;
+        {
+            std::unique_lock lock(index_mutex);
+            index_cv.wait(lock, [&] {
+                return filter_stop || index_done || line_count >= (block + 1) * LINES_PER_BLOCK;
+            });
+            if (filter_stop) return;
+
+            lines = line_count;
+            if (block * LINES_PER_BLOCK >= lines) break; // only reachable once indexing is done
+            offset = block_offsets[block];
+        }
+
+        const std::size_t block_lines = std::min(LINES_PER_BLOCK, lines - block * LINES_PER_BLOCK);
+        for (std::size_t i = 0; i < block_lines; i++) {
+            std::uint64_t next;
+            if (filter.Matches(LineAt(offset, &next))) matches++;
+            offset = next;
+        }
+
+        std::lock_guard lock(filter_mutex);
+        match_prefix.push_back(matches);
+    }
+
+    filter_done = true;
+}
+
+std::uint64_t LogViewer::BlockOffset(const std::size_t block) {
+    std::lock_guard lock(index_mutex);
+    return block_offsets[block];
+}
+
+/**
+ * @brief Get the text of the line starting at offset
+ * @param next output for the offset of the following line
+ */
+std::string_view LogViewer::LineAt(const std::uint64_t offset, std::uint64_t* next) const {
+    const char*       data  = file.Data();
+    const std::size_t size  = file.Size();
+    const char*       begin = data + offset;
+    const char*       end   = static_cast<const char*>(std::memchr(begin, '\n', size - offset));
+
+    if (end) {
+        *next = static_cast<std::uint64_t>(end - data) + 1;
+    }
+    else {
+        end   = data + size;
+        *next = size;
+    }
+
+    if (end > begin && end[-1] == '\r') end--;
+    return {begin, static_cast<std::size_t>(end - begin)};
+}
+
+static void DrawLine(std::string_view line, const ImVec4 (&level_colors)[3]) {
+    ImGui::PushStyleColor(ImGuiCol_Text, level_colors[LineLevel(line)]);
+    line = line.substr(0, MAX_DISPLAY_LINE);
+    ImGui::TextUnformatted(line.data(), line.data() + line.size());
+    ImGui::PopStyleColor();
+}
+
+void LogViewer::DrawLines(const ImVec4 (&level_colors)[3]) {
+    ImGuiListClipper clipper;
+
+    if (!active_filter.IsActive()) {
+        clipper.Begin(static_cast<int>(std::min<std::size_t>(line_count, INT32_MAX)));
+        while (clipper.Step()) {
+            const std::size_t first  = static_cast<std::size_t>(clipper.DisplayStart);
+            std::uint64_t     offset = BlockOffset(first / LINES_PER_BLOCK);
+
+            // skip to the first visible line within its block
+            std::uint64_t next;
+            for (std::size_t i = 0; i < first % LINES_PER_BLOCK; i++) {
+                LineAt(offset, &next);
+                offset = next;
+            }
+
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                DrawLine(LineAt(offset, &next), level_colors);
+                offset = next;
+            }
+        }
+        return;
+    }
+
+    std::uint64_t total_matches;
+    {
+        std::lock_guard lock(filter_mutex);
+        total_matches = match_prefix.back();
+    }
+
+    clipper.Begin(static_cast<int>(std::min<std::uint64_t>(total_matches, INT32_MAX)));
+    while (clipper.Step()) {
+        // find the block holding the first visible match
+        std::size_t   block;
+        std::uint64_t match;
+        {
+            std::lock_guard lock(filter_mutex);
+            const auto      it = std::upper_bound(match_prefix.begin(), match_prefix.end(),
+                                                  static_cast<std::uint64_t>(clipper.DisplayStart));
+            block              = static_cast<std::size_t>(it - match_prefix.begin()) - 1;
+            match              = match_prefix[block];
+        }
+
+        std::uint64_t       offset = BlockOffset(block);
+        std::uint64_t       row    = static_cast<std::uint64_t>(clipper.DisplayStart);
+        const std::uint64_t end    = static_cast<std::uint64_t>(clipper.DisplayEnd);
+        while (row < end && offset < file.Size()) {
+            std::uint64_t          next;
+            const std::string_view line = LineAt(offset, &next);
+            offset                      = next;
+            if (!active_filter.Matches(line)) continue;
+
+            if (match == row) {
+                DrawLine(line, level_colors);
+                row++;
+            }
+            match++;
+        }
+    }
+}
+
+void LogViewer::UI(bool* open, const ImVec4 (&level_colors)[3]) {
+    if (!ImGui::Begin("Log File Viewer", open)) {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::SetNextItemWidth(-200.0f);
+    ImGui::InputText("##path", path_buffer, sizeof(path_buffer));
+    ImGui::SameLine();
+    if (ImGui::Button(file.IsOpen() ? "Reload" : "Open")) {
+        Open(path_buffer);
+    }
+    ImGui::SameLine();
+    ImGui::BeginDisabled(!file.IsOpen());
+    if (ImGui::Button("Close")) {
+        Close();
+    }
+    ImGui::EndDisabled();
+
+    ImGui::Checkbox("Info", &level_toggles[static_cast<int>(LogLevel::Info)]);
+    ImGui::SameLine();
+    ImGui::Checkbox("Warn", &level_toggles[static_cast<int>(LogLevel::Warn)]);
+    ImGui::SameLine();
+    ImGui::Checkbox("Error", &level_toggles[static_cast<int>(LogLevel::Error)]);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    ImGui::InputTextWithHint("##filter", "Filter (substring)", filter_buffer, sizeof(filter_buffer));
+
+    // restart the filter scan whenever the settings change
+    Filter filter;
+    filter.text = filter_buffer;
+    std::copy(std::begin(level_toggles), std::end(level_toggles), std::begin(filter.levels));
+    if (filter.text != active_filter.text || !std::equal(std::begin(filter.levels), std::end(filter.levels),
+                                                         std::begin(active_filter.levels))) {
+        active_filter = filter;
+        StartFilter();
+    }
+
+    if (file.IsOpen()) {
+        ImGui::Text("%s: %.1f MiB, %zu lines%s", path.string().c_str(), file.Size() / (1024.0 * 1024.0),
+                    line_count.load(), index_done ? "" : " (indexing...)");
+        if (active_filter.IsActive()) {
+            std::lock_guard lock(filter_mutex);
+            ImGui::SameLine();
+            ImGui::Text("| %llu matches%s", static_cast<unsigned long long>(match_prefix.back()),
+                        filter_done ? "" : " (searching...)");
+        }
+    }
+    else {
+        ImGui::TextUnformatted("No file open.");
+    }
+
+    ImGui::Separator();
+
+    if (ImGui::BeginChild("Log File Viewer|Lines", ImGui::GetContentRegionAvail(), ImGuiChildFlags_None,
+                          ImGuiWindowFlags_HorizontalScrollbar)) {
+        if (file.IsOpen()) {
+            DrawLines(level_colors);
+        }
+    }
+    ImGui::EndChild();
+
+    ImGui::End();
+}
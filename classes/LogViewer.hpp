@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "classes/Logger.hpp"
+#include "classes/MappedFile.hpp"
+
+struct ImVec4;
+
+/**
+ * @brief Viewer for existing log files (such as output.log) that may be far larger than memory.
+ *
+ * The file is memory-mapped and never copied. A background thread builds a sparse line index (one offset per block of
+ * LINES_PER_BLOCK lines), so the memory cost stays small even for multi-GB logs; visible lines are found by jumping to
+ * their block and scanning forward a handful of lines. Filters are applied by a second background thread that counts
+ * matches per block, which lets the clipper seek straight to the N-th matching line.
+ */
+class LogViewer {
+public:
+    static constexpr std::size_t LINES_PER_BLOCK = 64;
+
+    LogViewer() = default;
+    ~LogViewer();
+
+    LogViewer(const LogViewer&)            = delete;
+    LogViewer& operator=(const LogViewer&) = delete;
+
+    /**
+     * @brief Map a log file and start indexing it in the background
+     * @param path Log file to open
+     * @return true if the file could be mapped
+     */
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    /**
+     * @brief Draw the viewer window
+     * @param open Window visibility flag (cleared when the window is closed)
+     * @param level_colors Text colors for each LogLevel, shared with the live log window
+     */
+    void UI(bool* open, const ImVec4 (&level_colors)[3]);
+
+private:
+    struct Filter {
+        std::string text;
+        bool        levels[3] = {true, true, true};
+
+        bool IsActive() const { return !text.empty() || !levels[0] || !levels[1] || !levels[2]; }
+        bool Matches(std::string_view line) const;
+    };
+
+    void IndexWorker();
+    void FilterWorker(Filter filter);
+
+    void StartFilter();
+    void StopFilter();
+    void StopIndex();
+
+    std::uint64_t    BlockOffset(std::size_t block);
+    std::string_view LineAt(std::uint64_t offset, std::uint64_t* next) const;
+
+    void DrawLines(const ImVec4 (&level_colors)[3]);
+
+    MappedFile            file;
+    std::filesystem::path path;
+
+    // line index, written by the index thread
+    std::mutex                 index_mutex;
+    std::condition_variable    index_cv;
+    std::vector<std::uint64_t> block_offsets;
+    std::atomic<std::size_t>   line_count{0};
+    std::atomic<bool>          index_done{false};
+    std::atomic<bool>          index_stop{false};
+    std::thread                index_thread;
+
+    // filter results, written by the filter thread. match_prefix[b] is the number of matching lines before block b.
+    std::mutex                 filter_mutex;
+    std::vector<std::uint64_t> match_prefix{0};
+    std::atomic<bool>          filter_done{false};
+    std::atomic<bool>          filter_stop{false};
+    std::thread                filter_thread;
+    Filter                     active_filter;
+
+    // UI state
+    char path_buffer[512]   = "output.log";
+    char filter_buffer[256] = "";
+    bool level_toggles[3]   = {true, true, true};
+};
@@ -1,4 +1,6 @@
 #include "classes/Logger.hpp"
+#include "classes/FrameScheduler.hpp"
+#include "classes/LogViewer.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -16,6 +18,9 @@ static ImVec4 LOG_COLORS[3] = {
 };
 
 static bool show_log_options = false;
+static bool show_log_viewer = false;
+
+static LogViewer log_viewer;
 
 
 Logger& Logger::GetInstance() {
@@ -58,9 +63,18 @@ static std::string nowstr(std::chrono::system_clock::time_point now) {
 Logger::Logger() : output_file("output.log", std::ios::app | std::ios::out) {}
 
 void Logger::Log(const LogEntry &entry) {
-    std::cout << ANSI_LEVEL_COLORS[static_cast<int>(entry.log_level)] << entry.full_text << "\033[0m\n";
-    output_file << entry.full_text << std::endl;
-    log_entries.push_back(entry);
+    {
+        std::lock_guard lock(log_mutex);
+        std::cout << ANSI_LEVEL_COLORS[static_cast<int>(entry.log_level)] << entry.full_text << "\033[0m\n";
+        output_file << entry.full_text << std::endl;
+        log_entries.push_back(entry);
+        if (log_entries.size() > MAX_ENTRIES) {
+            log_entries.pop_front();
+        }
+    }
+
+    // the log window needs to show the new entry even if the render loop is idle
+    FrameScheduler::GetInstance().RequestFrame();
 }
 
 static std::string logtext(const LogEntry& entry) {
@@ -75,6 +89,7 @@ static std::string logtext(const LogEntry& entry) {
 }
 
 void Logger::Log(LogLevel level, const std::string_view message) {
+    if (!Enabled(level)) return;
     auto now = std::chrono::system_clock::now();
     LogEntry entry{};
     entry.log_level = level;
@@ -88,6 +103,7 @@ void Logger::Log(LogLevel level, const std::string_view message) {
 
 
 void Logger::Log(const std::string_view logger, LogLevel level, const std::string_view message) {
+    if (!Enabled(level)) return;
     auto now = std::chrono::system_clock::now();
     LogEntry entry{};
     entry.log_level = level;
@@ -131,6 +147,12 @@ void Logger::UI() {
 
         ImGui::SameLine();
 
+        if (ImGui::Button("Open Log File")) {
+            show_log_viewer = true;
+        }
+
+        ImGui::SameLine();
+
         if (ImGui::Button("Test Info")) {
             Logger::GetInstance().LogInfo("Hello Info!");
         }
@@ -150,6 +172,7 @@ void Logger::UI() {
         ImGui::Separator();
 
         if (ImGui::BeginChild("Game Log|LogOut", ImGui::GetContentRegionAvail(), ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar)) {
+            std::lock_guard lock(log_mutex);
             for (const auto& entry : Logger::GetInstance()) {
                 LogEntryUI(entry);
             }
@@ -162,4 +185,8 @@ void Logger::UI() {
     if (show_log_options) {
         LoggerOptions();
     }
+
+    if (show_log_viewer) {
+        log_viewer.UI(&show_log_viewer, LOG_COLORS);
+    }
 }
\ No newline at end of file
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <optional>
+#include <deque>
 #include <vector>
 #include <chrono>
 #include <fstream>
+#include <mutex>
 
 #if __has_include(<format>)
 #define LOGGER_USE_STD_FORMAT
@@ -70,6 +73,7 @@ public:
      */
     template<class... Args> requires(std::tuple_size_v<std::tuple<Args...>> > 0)
     void Log(LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        if (!Enabled(level)) return;
         const auto message = std::format(fmt, std::forward<Args>(args)...);
         Log(level, message);
     };
@@ -79,11 +83,19 @@ public:
      */
     template<class... Args> requires(std::tuple_size_v<std::tuple<Args...>> > 0)
     void Log(const std::string_view logger, LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        if (!Enabled(level)) return;
         const auto message = std::format(fmt, std::forward<Args>(args)...);
         Log(logger, level, message);
     };
     #endif
 
+    /**
+     * @brief Drop every message below a level, before it is even formatted (e.g. the game events when playing many
+     * games at once)
+     */
+    inline void SetMinimumLevel(LogLevel level) { minimum_level.store(level, std::memory_order_relaxed); };
+    inline bool Enabled(LogLevel level) const { return level >= minimum_level.load(std::memory_order_relaxed); };
+
     LOGFUNC_HELPER(Info, LogLevel::Info);
     LOGFUNC_HELPER(Warn, LogLevel::Warn);
     LOGFUNC_HELPER(Error, LogLevel::Error);
@@ -98,13 +110,19 @@ public:
     inline auto cbegin() const { return log_entries.cbegin(); };
     inline auto cend() const { return log_entries.cend(); };
 
-    inline void Clear() { log_entries.clear(); };
+    inline void Clear() { std::lock_guard lock(log_mutex); log_entries.clear(); };
 
 
     void UI();
 private:
-    std::vector<LogEntry> log_entries;
+    // the log window keeps the most recent entries, the whole log is in the output file
+    static constexpr std::size_t MAX_ENTRIES = 5000;
+
+    // entries can be logged from worker threads (e.g. the AI search), the UI iterates them on the main thread
+    std::mutex log_mutex;
+    std::deque<LogEntry> log_entries;
     std::ofstream output_file;
+    std::atomic<LogLevel> minimum_level{LogLevel::Info};
 };
 
 #undef LOGFUNC_HELPER
@@ -0,0 +1,110 @@
+#include "classes/MappedFile.hpp"
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef WIN32
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    if (file_size.QuadPart == 0) {
+        // can't map an empty file, but it is still a valid (empty) view
+        CloseHandle(file);
+        is_open = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle    = file;
+    mapping_handle = mapping;
+    data           = static_cast<const char*>(view);
+    size           = static_cast<std::size_t>(file_size.QuadPart);
+    is_open        = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) UnmapViewOfFile(data);
+    if (mapping_handle) CloseHandle(mapping_handle);
+    if (file_handle) CloseHandle(file_handle);
+
+    data           = nullptr;
+    size           = 0;
+    file_handle    = nullptr;
+    mapping_handle = nullptr;
+    is_open        = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    if (st.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        data = static_cast<const char*>(view);
+        size = static_cast<std::size_t>(st.st_size);
+    }
+
+    // the mapping keeps its own reference to the file
+    close(fd);
+    is_open = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) munmap(const_cast<char*>(data), size);
+
+    data    = nullptr;
+    size    = 0;
+    is_open = false;
+}
+
+#endif
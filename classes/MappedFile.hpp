@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The mapping is owned by the object and released on Close() or destruction. An empty file opens successfully with a
+ * null data pointer and a size of zero (most platforms refuse to map zero bytes).
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file for reading, closing any previous mapping first
+     * @param path File to map
+     * @return true if the file was mapped (or is empty)
+     */
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    inline bool             IsOpen() const { return is_open; };
+    inline const char*      Data() const { return data; };
+    inline std::size_t      Size() const { return size; };
+    inline std::string_view View() const { return {data, size}; };
+
+private:
+    const char* data    = nullptr;
+    std::size_t size    = 0;
+    bool        is_open = false;
+#ifdef WIN32
+    void* file_handle    = nullptr;
+    void* mapping_handle = nullptr;
+#endif
+};
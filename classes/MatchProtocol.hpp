@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Wire format between ttt_server and its clients (tools/ttt_server.cpp, tools/ttt_load.cpp).
+ *
+ * Both directions are a stream of fixed-size MatchMessages in host byte order (the server only listens on a Unix
+ * socket or on loopback). A client may keep any number of games going on one connection; every request gets exactly
+ * one reply, which carries the game it is about, but replies about different games don't come back in request order
+ * because the AI's moves are searched on worker threads.
+ *
+ *  request             reply
+ *  NEW_GAME  cell=seat STARTED  game, cell=the AI's first move if it moves first (else NO_CELL), result
+ *  MOVE      game,cell MOVED    game, cell=the AI's answer (NO_CELL if the move ended the game), result
+ *  CLOSE     game      CLOSED   game
+ *  anything wrong      ERROR    game, cell=MatchError
+ *
+ * Cells count left-to-right, top-to-bottom from 0. The client's seat is 0 to move first (X), 1 to let the AI open.
+ * A game is closed by the server once it's over, sending CLOSE for it is only needed to give a game up.
+ */
+namespace MatchProtocol {
+    enum MessageType : std::uint8_t {
+        NEW_GAME = 1,
+        MOVE     = 2,
+        CLOSE    = 3,
+
+        STARTED = 0x81,
+        MOVED   = 0x82,
+        CLOSED  = 0x83,
+        ERROR   = 0xff,
+    };
+
+    enum MatchResult : std::uint8_t {
+        PLAYING    = 0,
+        CLIENT_WON = 1,
+        SERVER_WON = 2,
+        DRAW       = 3,
+    };
+
+    enum MatchError : std::uint8_t {
+        BAD_REQUEST   = 1, // unknown message type or seat
+        NO_SUCH_GAME  = 2, // never started, already over or another connection's
+        NOT_YOUR_TURN = 3, // the AI is still searching its move
+        ILLEGAL_MOVE  = 4, // off the board or taken
+        SERVER_FULL   = 5,
+    };
+
+    constexpr std::uint8_t NO_CELL = 0xff;
+
+    struct MatchMessage {
+        std::uint8_t  type;
+        std::uint8_t  cell;
+        std::uint8_t  result;
+        std::uint8_t  reserved;
+        std::uint32_t game;
+    };
+    static_assert(sizeof(MatchMessage) == 8, "MatchMessage is the wire format");
+
+    constexpr const char* DEFAULT_SOCKET = "/tmp/ttt_server.sock";
+} // namespace MatchProtocol
@@ -0,0 +1,138 @@
+#include "classes/MoveLog.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+static std::size_t WriteVarint(std::uint64_t value, std::uint8_t* out) {
+    std::size_t size = 0;
+    while (value >= 0x80) {
+        out[size++] = static_cast<std::uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = static_cast<std::uint8_t>(value);
+    return size;
+}
+
+static std::size_t ReadVarint(const std::uint8_t* in, std::uint64_t& value) {
+    std::size_t size  = 0;
+    int         shift = 0;
+    value             = 0;
+    do {
+        value |= static_cast<std::uint64_t>(in[size] & 0x7f) << shift;
+        shift += 7;
+    } while (in[size++] & 0x80);
+    return size;
+}
+
+std::size_t MoveLog::EncodeMove(const Move& move, std::uint8_t* out) {
+    const bool          picked_up = move.to != NO_CELL && move.from != NO_CELL;
+    const std::uint64_t to        = move.to == NO_CELL ? 0 : static_cast<std::uint64_t>(move.to) + 1;
+    std::size_t         size      = WriteVarint(to << 1 | (picked_up ? 1 : 0), out);
+    if (picked_up) {
+        size += WriteVarint(move.from, out + size);
+    }
+    return size;
+}
+
+std::size_t MoveLog::DecodeMove(const std::uint8_t* in, Move& move) {
+    std::uint64_t code = 0;
+    std::size_t   size = ReadVarint(in, code);
+    move.to            = (code >> 1) == 0 ? NO_CELL : static_cast<std::uint32_t>((code >> 1) - 1);
+    move.from          = NO_CELL;
+    if (code & 1) {
+        std::uint64_t from = 0;
+        size += ReadVarint(in + size, from);
+        move.from = static_cast<std::uint32_t>(from);
+    }
+    return size;
+}
+
+void MoveLog::Reset(const std::size_t board_cells, const unsigned int player_count, const std::uint8_t* board,
+                    const std::uint32_t interval) {
+    cells             = static_cast<std::uint32_t>(board_cells);
+    players           = static_cast<std::uint16_t>(std::max(player_count, 1u));
+    keyframe_interval = static_cast<std::uint16_t>(std::clamp<std::uint32_t>(interval, 1, 0xffff));
+    count             = 0;
+    moves.clear();
+
+    keyframes.assign(KeyframeStride(), 0);
+    if (board) {
+        std::memcpy(keyframes.data() + sizeof(std::uint32_t), board, cells);
+    }
+}
+
+void MoveLog::ApplyMove(const std::size_t index, const Move& move, std::uint8_t* board) const {
+    if (move.to == NO_CELL || move.to >= cells) return;
+    if (move.from != NO_CELL && move.from < cells) {
+        board[move.to]   = board[move.from];
+        board[move.from] = 0;
+    }
+    else {
+        board[move.to] = static_cast<std::uint8_t>(index % players + 1);
+    }
+}
+
+void MoveLog::Append(const Move& move) {
+    std::uint8_t encoded[MAX_ENCODED_MOVE];
+    moves.insert(moves.end(), encoded, encoded + EncodeMove(move, encoded));
+    count++;
+
+    if (count % keyframe_interval == 0) {
+        // the board comes from the previous keyframe, so this costs one interval of moves every interval
+        const std::size_t record = keyframes.size();
+        keyframes.resize(record + KeyframeStride());
+        const std::uint32_t offset = static_cast<std::uint32_t>(moves.size());
+        std::memcpy(&keyframes[record], &offset, sizeof(offset));
+        BoardFromKeyframe(count / keyframe_interval - 1, count, &keyframes[record + sizeof(std::uint32_t)]);
+    }
+}
+
+void MoveLog::Truncate(const std::size_t new_count) {
+    if (new_count >= count) return;
+
+    const std::size_t keyframe = new_count / keyframe_interval;
+    keyframes.resize((keyframe + 1) * KeyframeStride());
+
+    std::uint32_t offset = 0;
+    std::memcpy(&offset, &keyframes[keyframe * KeyframeStride()], sizeof(offset));
+    Move skipped;
+    for (std::size_t i = keyframe * keyframe_interval; i < new_count; i++) {
+        offset += static_cast<std::uint32_t>(DecodeMove(&moves[offset], skipped));
+    }
+    moves.resize(offset);
+    count = static_cast<std::uint32_t>(new_count);
+}
+
+MoveLog::Move MoveLog::MoveAt(const std::size_t index) const {
+    const std::size_t keyframe = index / keyframe_interval;
+    std::uint32_t     offset   = 0;
+    std::memcpy(&offset, &keyframes[keyframe * KeyframeStride()], sizeof(offset));
+
+    Move move;
+    for (std::size_t i = keyframe * keyframe_interval; i <= index; i++) {
+        offset += static_cast<std::uint32_t>(DecodeMove(&moves[offset], move));
+    }
+    return move;
+}
+
+void MoveLog::BoardAt(const std::size_t turn, std::uint8_t* board) const {
+    const std::size_t clamped = std::min<std::size_t>(turn, count);
+    BoardFromKeyframe(clamped / keyframe_interval, clamped, board);
+}
+
+void MoveLog::BoardFromKeyframe(const std::size_t keyframe, const std::size_t turn, std::uint8_t* board) const {
+    const std::size_t record = keyframe * KeyframeStride();
+    std::uint32_t     offset = 0;
+    std::memcpy(&offset, &keyframes[record], sizeof(offset));
+    std::memcpy(board, &keyframes[record + sizeof(std::uint32_t)], cells);
+
+    Move move;
+    for (std::size_t i = keyframe * keyframe_interval; i < turn; i++) {
+        offset += static_cast<std::uint32_t>(DecodeMove(&moves[offset], move));
+        ApplyMove(i, move, board);
+    }
+}
+
+std::size_t MoveLog::MemoryBytes() const {
+    return sizeof(*this) + moves.capacity() + keyframes.capacity();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Compact record of one game's moves, with periodic board keyframes for random access.
+ *
+ * A move is stored as the varint ((to + 1) << 1 | picked_up), followed by the varint from when a bit was picked up
+ * rather than placed, so every placement on a board of up to 63 cells (a 3x3 board included) takes one byte. A move
+ * with no cell at all records a turn that changed nothing. Move i is made by player i % players, the same order as
+ * Game::getCurrentPlayer(), so players aren't stored.
+ *
+ * Every keyframe_interval moves the whole board is kept (one byte per cell: 0 when empty, otherwise the owner's player
+ * number + 1, as in the state strings) along with the byte offset of the move that follows, so the board at any turn
+ * is one keyframe plus fewer than keyframe_interval moves away.
+ */
+class MoveLog {
+public:
+    static constexpr std::uint32_t NO_CELL                   = 0xffffffffu;
+    static constexpr std::uint32_t DEFAULT_KEYFRAME_INTERVAL = 16;
+
+    struct Move {
+        std::uint32_t from = NO_CELL; // NO_CELL when the bit was placed rather than moved
+        std::uint32_t to   = NO_CELL; // NO_CELL when the turn changed nothing
+    };
+
+    /**
+     * @brief Forget every move and start a new game
+     * @param cells Number of cells on the board
+     * @param players Number of players taking turns
+     * @param board The board before the first move, one byte per cell (may be nullptr for an empty board)
+     * @param keyframe_interval Moves between two board keyframes
+     */
+    void Reset(std::size_t cells, unsigned int players, const std::uint8_t* board,
+               std::uint32_t keyframe_interval = DEFAULT_KEYFRAME_INTERVAL);
+
+    void Append(const Move& move);
+    /**
+     * @brief Drop every move after the first count
+     */
+    void Truncate(std::size_t count);
+
+    inline std::size_t Size() const { return count; };
+    inline std::size_t Cells() const { return cells; };
+    inline unsigned int Players() const { return players; };
+    Move                MoveAt(std::size_t index) const;
+
+    /**
+     * @brief The board after the first turn moves
+     * @param board Receives Cells() bytes
+     */
+    void BoardAt(std::size_t turn, std::uint8_t* board) const;
+
+    /// The encoded moves, without keyframes.
+    inline const std::vector<std::uint8_t>& Encoded() const { return moves; };
+    /// Heap and object bytes held by this log.
+    std::size_t MemoryBytes() const;
+
+    static std::size_t EncodeMove(const Move& move, std::uint8_t* out);
+    static std::size_t DecodeMove(const std::uint8_t* in, Move& move);
+    /// Bytes EncodeMove() writes at most.
+    static constexpr std::size_t MAX_ENCODED_MOVE = 10;
+
+private:
+    void ApplyMove(std::size_t index, const Move& move, std::uint8_t* board) const;
+    void BoardFromKeyframe(std::size_t keyframe, std::size_t turn, std::uint8_t* board) const;
+    // the keyframe record: the offset of the next move in moves, then the board
+    inline std::size_t KeyframeStride() const { return sizeof(std::uint32_t) + cells; };
+
+    std::vector<std::uint8_t> moves;
+    std::vector<std::uint8_t> keyframes;
+    std::uint32_t             cells             = 0;
+    std::uint32_t             count             = 0;
+    std::uint16_t             players           = 1;
+    std::uint16_t             keyframe_interval = DEFAULT_KEYFRAME_INTERVAL;
+};
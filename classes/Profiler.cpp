@@ -0,0 +1,270 @@
+#include "classes/Profiler.hpp"
+
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <string_view>
+
+#include "classes/Logger.hpp"
+#include "imgui/imgui.h"
+
+/// Weight of the newest frame in each zone's moving average.
+static constexpr double AVERAGE_WEIGHT = 0.05;
+
+Profiler& Profiler::GetInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+void ProfileHistogram::Record(const std::uint64_t value) {
+    buckets[static_cast<std::size_t>(std::bit_width(value))].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    std::uint64_t current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+std::uint64_t ProfileHistogram::Percentile(const double fraction) const {
+    const std::uint64_t total = count.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+
+    const auto    target     = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(total)));
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < BUCKETS; i++) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        if (cumulative >= target) {
+            // bucket i holds values in [2^(i-1), 2^i)
+            const std::uint64_t upper = i == 0 ? 0 : i >= 64 ? UINT64_MAX : (std::uint64_t{1} << i) - 1;
+            return std::min(upper, max.load(std::memory_order_relaxed));
+        }
+    }
+    return max.load(std::memory_order_relaxed);
+}
+
+ProfileZone* Profiler::RegisterZone(const char* name) {
+    std::lock_guard lock(registry_mutex);
+    return &zones.emplace_back(name);
+}
+
+ProfileCounter* Profiler::RegisterCounter(const char* name) {
+    std::lock_guard lock(registry_mutex);
+    return &counters.emplace_back(name);
+}
+
+ProfileHistogram* Profiler::RegisterHistogram(const char* name) {
+    std::lock_guard lock(registry_mutex);
+    return &histograms.emplace_back(name);
+}
+
+void Profiler::NewFrame() {
+    const auto now = Clock::now();
+
+    if (!frame_histogram) {
+        frame_histogram = RegisterHistogram("Frame time (us)");
+    }
+
+    if (frame_number > 0) {
+        const auto frame_time = now - frame_start;
+        last_frame_ms         = std::chrono::duration<double, std::milli>(frame_time).count();
+        frame_history_ms[history_index] = static_cast<float>(last_frame_ms);
+        frame_histogram->Record(
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(frame_time).count()));
+    }
+
+    {
+        std::lock_guard lock(registry_mutex);
+        for (auto& zone : zones) {
+            const std::uint64_t ns = zone.frame_ns.exchange(0, std::memory_order_relaxed);
+            zone.last_calls        = zone.frame_calls.exchange(0, std::memory_order_relaxed);
+            zone.last_ms           = static_cast<double>(ns) / 1.0e6;
+            zone.average_ms        = zone.average_ms + (zone.last_ms - zone.average_ms) * AVERAGE_WEIGHT;
+            zone.history_ms[history_index] = static_cast<float>(zone.last_ms);
+        }
+
+        for (auto& counter : counters) {
+            const std::uint64_t total = counter.total.load(std::memory_order_relaxed);
+            counter.last_frame        = total - counter.frame_start;
+            counter.frame_start       = total;
+        }
+    }
+
+    history_index = (history_index + 1) % ProfileZone::HISTORY;
+    frame_start   = now;
+    frame_number++;
+}
+
+static void WriteJSONString(std::ofstream& out, const std::string_view text) {
+    out << '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+bool Profiler::DumpJSON(const std::filesystem::path& path) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out) return false;
+
+    std::lock_guard lock(registry_mutex);
+
+    out << "{\n  \"frame\": " << frame_number << ",\n  \"frame_ms\": " << last_frame_ms << ",\n  \"zones\": [";
+    for (std::size_t i = 0; i < zones.size(); i++) {
+        const auto& zone = zones[i];
+        out << (i ? ",\n    {" : "\n    {") << "\"name\": ";
+        WriteJSONString(out, zone.name);
+        out << ", \"calls\": " << zone.last_calls << ", \"last_ms\": " << zone.last_ms
+            << ", \"average_ms\": " << zone.average_ms << ", \"history_ms\": [";
+        // oldest first
+        for (std::size_t h = 0; h < ProfileZone::HISTORY; h++) {
+            out << (h ? ", " : "") << zone.history_ms[(history_index + h) % ProfileZone::HISTORY];
+        }
+        out << "]}";
+    }
+
+    out << "\n  ],\n  \"counters\": [";
+    for (std::size_t i = 0; i < counters.size(); i++) {
+        const auto& counter = counters[i];
+        out << (i ? ",\n    {" : "\n    {") << "\"name\": ";
+        WriteJSONString(out, counter.name);
+        out << ", \"last_frame\": " << counter.last_frame << ", \"total\": " << counter.total.load() << "}";
+    }
+
+    out << "\n  ],\n  \"histograms\": [";
+    for (std::size_t i = 0; i < histograms.size(); i++) {
+        const auto& histogram = histograms[i];
+        out << (i ? ",\n    {" : "\n    {") << "\"name\": ";
+        WriteJSONString(out, histogram.name);
+        out << ", \"count\": " << histogram.count.load() << ", \"max\": " << histogram.max.load()
+            << ", \"p50\": " << histogram.Percentile(0.5) << ", \"p90\": " << histogram.Percentile(0.9)
+            << ", \"p99\": " << histogram.Percentile(0.99) << ", \"log2_buckets\": [";
+        for (std::size_t b = 0; b < ProfileHistogram::BUCKETS; b++) {
+            out << (b ? ", " : "") << histogram.buckets[b].load();
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+
+    return static_cast<bool>(out);
+}
+
+void Profiler::UI() {
+    if (!ImGui::Begin("Profiler")) {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Frame %llu: %.3f ms (%.1f fps)", static_cast<unsigned long long>(frame_number), last_frame_ms,
+                last_frame_ms > 0.0 ? 1000.0 / last_frame_ms : 0.0);
+    ImGui::SameLine();
+    if (ImGui::Button("Dump JSON")) {
+        if (DumpJSON("profile.json")) {
+            Logger::GetInstance().LogInfo("Profiler stats written to profile.json");
+        }
+        else {
+            Logger::GetInstance().LogError("Could not write profile.json");
+        }
+    }
+
+    Tracer& tracer = Tracer::GetInstance();
+    if (tracer.IsRecording()) {
+        if (ImGui::Button("Stop Trace")) {
+            tracer.Stop();
+        }
+    }
+    else if (ImGui::Button("Start Trace")) {
+        tracer.Start();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save Trace")) {
+        if (tracer.Flush("trace.json")) {
+            Logger::GetInstance().LogInfo("Trace written to trace.json (open it in chrome://tracing or Perfetto)");
+        }
+        else {
+            Logger::GetInstance().LogError("Could not write trace.json");
+        }
+    }
+    if (tracer.IsRecording()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted("Recording...");
+    }
+
+    ImGui::PlotLines("##frame_ms", frame_history_ms.data(), static_cast<int>(frame_history_ms.size()),
+                     static_cast<int>(history_index), "frame ms", 0.0f, FLT_MAX, ImVec2(-FLT_MIN, 60.0f));
+
+    std::lock_guard lock(registry_mutex);
+
+    constexpr ImGuiTableFlags TABLE_FLAGS = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp;
+
+    if (ImGui::CollapsingHeader("Zones (inclusive)", ImGuiTreeNodeFlags_DefaultOpen) &&
+        ImGui::BeginTable("Profiler|Zones", 5, TABLE_FLAGS)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Frame ms");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("Peak ms");
+        ImGui::TableHeadersRow();
+        for (const auto& zone : zones) {
+            float peak = 0.0f;
+            for (const float ms : zone.history_ms) peak = std::max(peak, ms);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(zone.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(zone.last_calls));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.last_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.average_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", peak);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::CollapsingHeader("Counters", ImGuiTreeNodeFlags_DefaultOpen) &&
+        ImGui::BeginTable("Profiler|Counters", 3, TABLE_FLAGS)) {
+        ImGui::TableSetupColumn("Counter");
+        ImGui::TableSetupColumn("Last frame");
+        ImGui::TableSetupColumn("Total");
+        ImGui::TableHeadersRow();
+        for (const auto& counter : counters) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(counter.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(counter.last_frame));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(counter.total.load(std::memory_order_relaxed)));
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::CollapsingHeader("Histograms", ImGuiTreeNodeFlags_DefaultOpen) &&
+        ImGui::BeginTable("Profiler|Histograms", 6, TABLE_FLAGS)) {
+        ImGui::TableSetupColumn("Histogram");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p90");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("Max");
+        ImGui::TableHeadersRow();
+        for (const auto& histogram : histograms) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(histogram.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(histogram.count.load(std::memory_order_relaxed)));
+            for (const double p : {0.5, 0.9, 0.99}) {
+                ImGui::TableNextColumn();
+                ImGui::Text("<= %llu", static_cast<unsigned long long>(histogram.Percentile(p)));
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(histogram.max.load(std::memory_order_relaxed)));
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
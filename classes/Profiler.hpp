@@ -0,0 +1,157 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+
+#include "classes/Tracer.hpp"
+
+/**
+ * @brief A named block of code whose time is accumulated every frame (see PROFILE_ZONE)
+ *
+ * The atomics are written from any thread; the rest is owned by the thread calling Profiler::NewFrame().
+ */
+struct ProfileZone {
+    static constexpr std::size_t HISTORY = 120;
+
+    explicit ProfileZone(const char* zone_name) : name(zone_name) {}
+
+    const char*                name;
+    std::atomic<std::uint64_t> frame_ns{0};
+    std::atomic<std::uint64_t> frame_calls{0};
+
+    // results of the last completed frame
+    double                     last_ms    = 0.0;
+    std::uint64_t              last_calls = 0;
+    double                     average_ms = 0.0;
+    std::array<float, HISTORY> history_ms{};
+};
+
+/**
+ * @brief A monotonic counter, reported both as a per-frame delta and a running total (see PROFILE_COUNTER_ADD)
+ */
+struct ProfileCounter {
+    explicit ProfileCounter(const char* counter_name) : name(counter_name) {}
+
+    const char*                name;
+    std::atomic<std::uint64_t> total{0};
+
+    std::uint64_t frame_start = 0;
+    std::uint64_t last_frame  = 0;
+};
+
+/**
+ * @brief A log2-bucketed histogram of non-negative values (see PROFILE_HISTOGRAM_RECORD)
+ */
+struct ProfileHistogram {
+    static constexpr std::size_t BUCKETS = 65;
+
+    explicit ProfileHistogram(const char* histogram_name) : name(histogram_name) {}
+
+    void Record(std::uint64_t value);
+
+    /**
+     * @brief Estimate a percentile of the recorded values
+     * @param fraction Percentile in [0, 1]
+     * @return The upper bound of the bucket that holds the percentile
+     */
+    std::uint64_t Percentile(double fraction) const;
+
+    const char*                                      name;
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+    std::atomic<std::uint64_t>                       count{0};
+    std::atomic<std::uint64_t>                       max{0};
+};
+
+/**
+ * @brief Lightweight instrumentation: scoped zones, counters and histograms, with a per-frame breakdown in the
+ * "Profiler" window and a JSON dump for offline analysis.
+ *
+ * Zones, counters and histograms are registered once per call site (the macros cache the pointer in a function-local
+ * static), so the steady-state cost of a zone is two clock reads and two relaxed atomic adds.
+ */
+class Profiler {
+    Profiler() = default;
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static Profiler& GetInstance();
+
+    ProfileZone*      RegisterZone(const char* name);
+    ProfileCounter*   RegisterCounter(const char* name);
+    ProfileHistogram* RegisterHistogram(const char* name);
+
+    /**
+     * @brief Close the previous frame's stats and start a new frame. Called once per frame from the render loop.
+     */
+    void NewFrame();
+
+    /**
+     * @brief Write the current stats (zones, counters, histograms) as JSON
+     * @param path Output file
+     * @return true on success
+     */
+    bool DumpJSON(const std::filesystem::path& path);
+
+    void UI();
+
+private:
+    std::mutex                   registry_mutex;
+    std::deque<ProfileZone>      zones;
+    std::deque<ProfileCounter>   counters;
+    std::deque<ProfileHistogram> histograms;
+
+    ProfileHistogram*                       frame_histogram = nullptr;
+    Clock::time_point                       frame_start{};
+    std::uint64_t                           frame_number  = 0;
+    double                                  last_frame_ms = 0.0;
+    std::size_t                             history_index = 0;
+    std::array<float, ProfileZone::HISTORY> frame_history_ms{};
+};
+
+/**
+ * @brief RAII timer that adds its lifetime to a ProfileZone (and to the trace, when the Tracer is recording)
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileZone* scope_zone)
+        : zone(scope_zone), trace(scope_zone->name), start(Profiler::Clock::now()) {}
+    ~ProfileScope() {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Profiler::Clock::now() - start);
+        zone->frame_ns.fetch_add(static_cast<std::uint64_t>(elapsed.count()), std::memory_order_relaxed);
+        zone->frame_calls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ProfileScope(const ProfileScope&)            = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileZone*                zone;
+    TraceScope                  trace;
+    Profiler::Clock::time_point start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b)       PROFILE_CONCAT_INNER(a, b)
+
+// time the rest of the enclosing scope under the given (string literal) name
+#define PROFILE_ZONE(name)                                                                                            \
+    static ProfileZone* PROFILE_CONCAT(profile_zone_, __LINE__) = Profiler::GetInstance().RegisterZone(name);         \
+    ProfileScope        PROFILE_CONCAT(profile_scope_, __LINE__)(PROFILE_CONCAT(profile_zone_, __LINE__))
+
+#define PROFILE_COUNTER_ADD(name, value)                                                                              \
+    do {                                                                                                              \
+        static ProfileCounter* profile_counter = Profiler::GetInstance().RegisterCounter(name);                       \
+        profile_counter->total.fetch_add(static_cast<std::uint64_t>(value), std::memory_order_relaxed);               \
+    } while (0)
+
+#define PROFILE_HISTOGRAM_RECORD(name, value)                                                                         \
+    do {                                                                                                              \
+        static ProfileHistogram* profile_histogram = Profiler::GetInstance().RegisterHistogram(name);                 \
+        profile_histogram->Record(static_cast<std::uint64_t>(value));                                                 \
+    } while (0)
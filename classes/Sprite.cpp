@@ -1,123 +1,117 @@
-#ifdef DEMO_USE_GLAD_FOR_GL
-#include <glad/gl.h>
-#endif
-
 #include "Sprite.h"
+#include "Profiler.hpp"
+#include "TextureAtlas.hpp"
+#include "TextureLoader.hpp"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
-#include <iostream>
 #include <filesystem>
 
-// Simple helper function to load an image into a OpenGL texture with common settings
+// Point the sprite at its image, either a region of the texture atlas or a texture of its own
 bool Sprite::LoadTextureFromFile(const char* filename)
 {
-    // Load from file
-    int image_width = 0;
-    int image_height = 0;
-    std::filesystem::path resourcePath = std::filesystem::path("resources") / filename;
-    std::string newFilename = resourcePath.string();
-    unsigned char* image_data = stbi_load(newFilename.c_str(), &image_width, &image_height, NULL, 4);
-    if (image_data == NULL) {
-        _size = ImVec2(0, 0);
-        std::cout << "Failed to load texture: " << newFilename << std::endl;
-        return false;
-    }
-    _texture = _loadTextureFromMemory(image_data, image_width, image_height);
-    stbi_image_free(image_data);
-    if (_texture == 0) {
-        _size = ImVec2(0, 0);
-        return false;
+    PROFILE_ZONE("Sprite::LoadTextureFromFile");
+
+    // everything in resources/ is normally packed into the atlas, so this is just a lookup
+    const TextureAtlas& atlas = TextureAtlas::GetInstance();
+    if (const AtlasRegion* region = atlas.Find(filename)) {
+        _texture = atlas.Texture();
+        _uv0 = region->uv0;
+        _uv1 = region->uv1;
+        _size = region->size;
+        _pendingTexture.reset();
+        markDirty();
+        return true;
     }
-    _size = ImVec2((float)image_width, (float)image_height);
-    return true;
-}
 
-void Sprite::setHighlighted(bool highlighted)
-{
-	if (highlighted != _highlighted) {
-		_highlighted = highlighted;
-	}
+    // anything else is decoded on the loader threads, and picked up by paintSprite() once it has been uploaded
+    std::filesystem::path resourcePath = std::filesystem::path("resources") / filename;
+    _pendingTexture = TextureLoader::GetInstance().Load(resourcePath);
+    _texture = 0;
+    _uv0 = ImVec2(0, 0);
+    _uv1 = ImVec2(1, 1);
+    _size = _pendingTexture->size;
+    markDirty();
+    return _pendingTexture->state != LoadedTexture::State::Failed;
 }
 
-bool Sprite::highlighted()
+void Sprite::updateTexture()
 {
-	return _highlighted;
+    if (!_pendingTexture) {
+        return;
+    }
+    switch (_pendingTexture->state) {
+    case LoadedTexture::State::Ready:
+        _texture = _pendingTexture->texture;
+        _size = _pendingTexture->size;
+        _pendingTexture.reset();
+        markDirty();
+        break;
+    case LoadedTexture::State::Failed:
+        _size = ImVec2(0, 0);
+        _pendingTexture.reset();
+        markDirty();
+        break;
+    case LoadedTexture::State::Loading:
+        break;
+    }
 }
 
-#ifdef WIN32
-// DirectX
-#include <stdio.h>
-#include <d3d11.h>
-#include <d3dcompiler.h>
-#ifdef _MSC_VER
-#pragma comment(lib, "d3dcompiler") // Automatically link with d3dcompiler.lib as we are using D3DCompile() below.
-#endif
-
-ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
+//
+// draw straight into the window's draw list so consecutive sprites sharing the atlas texture merge into one draw command
+//
+void Sprite::paintSprite()
 {
-    // Create texture
-    D3D11_TEXTURE2D_DESC desc;
-    ZeroMemory(&desc, sizeof(desc));
-    desc.Width = image_width;
-    desc.Height = image_height;
-    desc.MipLevels = 1;
-    desc.ArraySize = 1;
-    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    desc.SampleDesc.Count = 1;
-    desc.Usage = D3D11_USAGE_DEFAULT;
-    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-    desc.CPUAccessFlags = 0;
-
-    ID3D11Texture2D *pTexture = NULL;
-    D3D11_SUBRESOURCE_DATA subResource;
-    subResource.pSysMem = image_data;
-    subResource.SysMemPitch = desc.Width * 4;
-    subResource.SysMemSlicePitch = 0;
-
-    // You need to have a valid ID3D11Device* available as g_pd3dDevice
-    extern ID3D11Device* g_pd3dDevice; // Add this line if g_pd3dDevice is defined elsewhere
-
-    HRESULT hr = g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
-    if (FAILED(hr) || !pTexture) {
-        return 0;
+    updateTexture();
+    if (_size.x <= 0.0f || _size.y <= 0.0f) {
+        return;
     }
 
-    // Create texture view
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
-    ZeroMemory(&srvDesc, sizeof(srvDesc));
-    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = desc.MipLevels;
-    srvDesc.Texture2D.MostDetailedMip = 0;
-
-    ID3D11ShaderResourceView* shaderResourceView = nullptr;
-    hr = g_pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &shaderResourceView);
-    pTexture->Release();
+    ImGui::SetCursorPos(_location);
+    const ImVec2 min = ImGui::GetCursorScreenPos();
+    const ImVec2 max(min.x + _size.x, min.y + _size.y);
+    ImGui::Dummy(_size);
+    if (!ImGui::IsItemVisible()) {
+        return;
+    }
 
-    if (FAILED(hr) || !shaderResourceView) {
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    const TextureAtlas &atlas = TextureAtlas::GetInstance();
+    if (_pendingTexture) {
+        // placeholder while loading
+        const ImU32 placeholder = ImGui::GetColorU32(ImVec4(0.5f, 0.5f, 0.5f, 0.25f));
+        if (atlas.IsBuilt()) {
+            drawList->AddImage(atlas.Texture(), min, max, atlas.WhiteUV(), atlas.WhiteUV(), placeholder);
+        } else {
+            drawList->AddRectFilled(min, max, placeholder);
+        }
+    } else {
+        drawList->AddImage(_texture, min, max, _uv0, _uv1, ImGui::GetColorU32(_color));
+    }
 
-        return 0;
+    if (_highlighted) {
+        const ImU32 highlight = ImGui::GetColorU32(ImVec4(1, 1, 0, 1));
+        if (_texture == atlas.Texture()) {
+            // four thin quads using the atlas' white texel, which keeps us in the same draw command
+            const ImVec2 white = atlas.WhiteUV();
+            drawList->AddImage(_texture, min, ImVec2(max.x, min.y + 1), white, white, highlight);
+            drawList->AddImage(_texture, ImVec2(min.x, max.y - 1), max, white, white, highlight);
+            drawList->AddImage(_texture, ImVec2(min.x, min.y + 1), ImVec2(min.x + 1, max.y - 1), white, white, highlight);
+            drawList->AddImage(_texture, ImVec2(max.x - 1, min.y + 1), ImVec2(max.x, max.y - 1), white, white, highlight);
+        } else {
+            drawList->AddRect(min, max, highlight);
+        }
     }
-    return reinterpret_cast<ImTextureID>(shaderResourceView);
 }
-#else
 
-ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
+void Sprite::setHighlighted(bool highlighted)
 {
-    // Create a OpenGL texture identifier
-    GLuint image_texture;
-    glGenTextures(1, &image_texture);
-    glBindTexture(GL_TEXTURE_2D, image_texture);
-
-    // Setup filtering parameters for display
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Upload pixels into texture
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
-
-    return static_cast<ImTextureID>(image_texture);
+	if (highlighted != _highlighted) {
+		_highlighted = highlighted;
+		markDirty();
+	}
 }
 
-#endif
-
+bool Sprite::highlighted()
+{
+	return _highlighted;
+}
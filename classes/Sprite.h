@@ -2,7 +2,11 @@
 #include "Entity.h"
 #include "../imgui/imgui.h"
 
+#include <atomic>
 #include <cinttypes>
+#include <memory>
+
+struct LoadedTexture;
 
 class Sprite : public Entity
 {
@@ -18,9 +22,13 @@ public:
         _scale(1),
         _color(1, 1, 1, 1),
         _localZOrder(0),
+        _texture(0),
+        _uv0(0, 0),
+        _uv1(1, 1),
         _highlighted(false)
         { 
             _entityType = EntitySprite;
+            markDirty();
         };
     ~Sprite() { if (_retainCount > 0) release(); }
     
@@ -28,17 +36,21 @@ public:
     void setPosition(float x, float y)
     {
         _location = ImVec2(x, y);
+        markDirty();
     }
     void setPosition(const ImVec2 &point)
     {
         _location = point;
+        markDirty();
     }
     const ImVec2 &getPosition() { return _location; }
 
     void setSize(float x, float y)
     {
         _size = ImVec2(x, y);
+        markDirty();
     }
+    const ImVec2 &getSize() const { return _size; }
     // set the rotation of the sprite
     void setRotation(float rotation) { _rotation = rotation; }
     // set the scale of the sprite
@@ -47,7 +59,9 @@ public:
     void setColor(float r, float g, float b, float a)
     {
         _color = ImVec4(r, g, b, a);
+        markDirty();
     }
+    const ImVec4 &getColor() const { return _color; }
     // set my Z order
     void setLocalZOrder(int localZOrder) { _localZOrder = localZOrder; }
     // get my Z order
@@ -55,17 +69,20 @@ public:
     // get rotation
     float getRotation() { return _rotation; }
     // moveTo
-    void moveTo(const ImVec2 &point) { _location = point; }
+    void moveTo(const ImVec2 &point) { _location = point; markDirty(); }
     // draw the sprite
-    void paintSprite()
-    {
-        if (_size.x > 0.0f && _size.y > 0.0f) 
-        {
-            ImGui::SetCursorPos(_location);
-            ImVec4 highlight = _highlighted ? ImVec4(1, 1, 0, 1) : ImVec4(0, 0, 0, 0);
-            ImGui::Image((void*)(intptr_t)_texture, _size, ImVec2(0, 0), ImVec2(1, 1), _color, highlight);
-        }
-    }
+    void paintSprite();
+    // pick up our texture if it finished loading since the last frame
+    void updateTexture();
+    // still waiting for the texture (a placeholder is drawn meanwhile)
+    bool textureLoading() const { return _pendingTexture != nullptr; }
+    ImTextureID getTexture() const { return _texture; }
+    const ImVec2 &getUV0() const { return _uv0; }
+    const ImVec2 &getUV1() const { return _uv1; }
+
+    // changes whenever anything about how the sprite is drawn changes; unique across all sprites, so a cached drawing
+    // of some sprite is only reused while the same sprite is in the same state
+    unsigned int drawVersion() const { return _drawVersion; }
 	// is the mouse over this position?
 	bool isMouseOver(const ImVec2 &mousePos)
     {
@@ -81,6 +98,12 @@ public:
 	bool	highlighted();
 
 private:
+    void markDirty() { _drawVersion = _drawVersionCounter.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+    // shared by the sprites of every game, which may be running on other threads
+    static inline std::atomic<unsigned int> _drawVersionCounter{0};
+    unsigned int _drawVersion;
+
     // the texture to use for this sprite
     // GLuint _texture;
     // the parent of this sprite
@@ -99,8 +122,11 @@ private:
     int _localZOrder;
     // the texture we're going to draw
     ImTextureID _texture;
+    // the part of the texture holding our image (a sub-rectangle when it comes from the texture atlas)
+    ImVec2 _uv0;
+    ImVec2 _uv1;
+    // set while our image is still being decoded; a placeholder is drawn until it's ready
+    std::shared_ptr<const LoadedTexture> _pendingTexture;
     // currently highlighted
    	bool	_highlighted;
-    // private platform specific texture loading
-    ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
 };
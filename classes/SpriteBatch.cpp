@@ -0,0 +1,258 @@
+#include "classes/SpriteBatch.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "classes/Logger.hpp"
+#include "classes/Profiler.hpp"
+
+#if defined(DEMO_USE_GLAD_FOR_GL) && !defined(DEMO_HEADLESS)
+#define SPRITE_BATCH_HAS_GL
+#include <glad/gl.h>
+#endif
+
+static bool batching_enabled = true;
+
+bool SpriteBatch::Enabled() {
+    return batching_enabled;
+}
+
+void SpriteBatch::SetEnabled(const bool enabled) {
+    batching_enabled = enabled;
+}
+
+void SpriteBatch::Resize(const std::size_t count) {
+    instances.resize(count);
+    dirty_first = 0;
+    dirty_last  = count;
+}
+
+void SpriteBatch::MarkDirty(const std::size_t first, const std::size_t count) {
+    if (count == 0) return;
+    if (dirty_first == dirty_last) {
+        dirty_first = first;
+        dirty_last  = first + count;
+    }
+    else {
+        dirty_first = std::min(dirty_first, first);
+        dirty_last  = std::max(dirty_last, first + count);
+    }
+}
+
+void SpriteBatch::Draw(ImDrawList* draw_list, const ImTextureID batch_texture) {
+    if (instances.empty()) return;
+
+    const ImGuiViewport* viewport = ImGui::GetWindowViewport();
+    texture      = batch_texture;
+    display_pos  = viewport->Pos;
+    display_size = viewport->Size;
+    draw_list->AddCallback(&SpriteBatch::RenderCallback, this);
+    draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+}
+
+#ifdef SPRITE_BATCH_HAS_GL
+
+namespace {
+    struct Renderer {
+        GLuint program            = 0;
+        GLuint vertex_array       = 0;
+        GLint  location_projection = -1;
+        GLint  location_texture   = -1;
+        // core glVertexAttribDivisor from 3.3, glVertexAttribDivisorARB on a 3.1 or 3.2 context
+        PFNGLVERTEXATTRIBDIVISORPROC vertex_attrib_divisor = nullptr;
+    };
+    Renderer renderer;
+
+    // the four corners come from gl_VertexID (drawn as a triangle strip), everything else is per instance
+    const char* VERTEX_SHADER = R"(
+uniform mat4 ProjMtx;
+in vec4 Rect;
+in vec4 UV;
+in vec4 Color;
+out vec2 Frag_UV;
+out vec4 Frag_Color;
+void main()
+{
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    Frag_UV = mix(UV.xy, UV.zw, corner);
+    Frag_Color = Color;
+    gl_Position = ProjMtx * vec4(mix(Rect.xy, Rect.zw, corner), 0.0, 1.0);
+}
+)";
+
+    const char* FRAGMENT_SHADER = R"(
+uniform sampler2D Texture;
+in vec2 Frag_UV;
+in vec4 Frag_Color;
+#if __VERSION__ >= 150
+out vec4 Out_Color;
+#define FRAG_COLOR Out_Color
+#else
+#define FRAG_COLOR gl_FragColor
+#endif
+void main()
+{
+    FRAG_COLOR = Frag_Color * texture(Texture, Frag_UV.st);
+}
+)";
+
+    GLuint CompileShader(const GLenum type, const char* glsl_version, const char* source) {
+        const GLchar* sources[] = {glsl_version, "\n", source};
+        const GLuint  shader    = glCreateShader(type);
+        glShaderSource(shader, 3, sources, nullptr);
+        glCompileShader(shader);
+
+        GLint status = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (!status) {
+            char log[1024];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            Logger::GetInstance().LogError("SpriteBatch: shader compile failed: {}", log);
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+} // namespace
+
+bool SpriteBatch::InitRenderer(const char* glsl_version) {
+    // glVertexAttribDivisor is core in 3.3, glDrawArraysInstanced in 3.1
+    if (!(GLAD_GL_VERSION_3_3 || (GLAD_GL_VERSION_3_1 && GLAD_GL_ARB_instanced_arrays))) return false;
+    renderer.vertex_attrib_divisor = GLAD_GL_VERSION_3_3 ? glVertexAttribDivisor : glVertexAttribDivisorARB;
+
+    const GLuint vertex   = CompileShader(GL_VERTEX_SHADER, glsl_version ? glsl_version : "#version 130", VERTEX_SHADER);
+    const GLuint fragment = CompileShader(GL_FRAGMENT_SHADER, glsl_version ? glsl_version : "#version 130", FRAGMENT_SHADER);
+    if (!vertex || !fragment) {
+        if (vertex) glDeleteShader(vertex);
+        if (fragment) glDeleteShader(fragment);
+        return false;
+    }
+
+    renderer.program = glCreateProgram();
+    glAttachShader(renderer.program, vertex);
+    glAttachShader(renderer.program, fragment);
+    glBindAttribLocation(renderer.program, 0, "Rect");
+    glBindAttribLocation(renderer.program, 1, "UV");
+    glBindAttribLocation(renderer.program, 2, "Color");
+    glLinkProgram(renderer.program);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    GLint status = 0;
+    glGetProgramiv(renderer.program, GL_LINK_STATUS, &status);
+    if (!status) {
+        Logger::GetInstance().LogError("SpriteBatch: program link failed");
+        ShutdownRenderer();
+        return false;
+    }
+    renderer.location_projection = glGetUniformLocation(renderer.program, "ProjMtx");
+    renderer.location_texture    = glGetUniformLocation(renderer.program, "Texture");
+
+    glGenVertexArrays(1, &renderer.vertex_array);
+    return true;
+}
+
+void SpriteBatch::ShutdownRenderer() {
+    if (renderer.vertex_array) glDeleteVertexArrays(1, &renderer.vertex_array);
+    if (renderer.program) glDeleteProgram(renderer.program);
+    renderer = Renderer{};
+}
+
+bool SpriteBatch::Available() {
+    return batching_enabled && renderer.program != 0;
+}
+
+SpriteBatch::~SpriteBatch() {
+    if (gpu_buffer && renderer.program) glDeleteBuffers(1, &gpu_buffer);
+}
+
+void SpriteBatch::RenderCallback(const ImDrawList* draw_list, const ImDrawCmd* command) {
+    PROFILE_ZONE("SpriteBatch render");
+    SpriteBatch& batch = *static_cast<SpriteBatch*>(command->UserCallbackData);
+    if (batch.instances.empty()) return;
+
+    // the vertex array records the instance buffer binding and attribute layout, so it's set up along with the buffer
+    glBindVertexArray(renderer.vertex_array);
+    if (!batch.gpu_buffer) {
+        glGenBuffers(1, &batch.gpu_buffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, batch.gpu_buffer);
+
+    const std::size_t stride = sizeof(SpriteInstance);
+    if (batch.gpu_capacity < batch.instances.size()) {
+        batch.gpu_capacity = batch.instances.size();
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(batch.gpu_capacity * stride), batch.instances.data(),
+                     GL_DYNAMIC_DRAW);
+        PROFILE_COUNTER_ADD("Sprite instances uploaded", batch.instances.size());
+    }
+    else if (batch.dirty_first != batch.dirty_last) {
+        const std::size_t last = std::min(batch.dirty_last, batch.instances.size());
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(batch.dirty_first * stride),
+                        static_cast<GLsizeiptr>((last - batch.dirty_first) * stride), &batch.instances[batch.dirty_first]);
+        PROFILE_COUNTER_ADD("Sprite instances uploaded", last - batch.dirty_first);
+    }
+    batch.dirty_first = batch.dirty_last = 0;
+
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(SpriteInstance, min)));
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(SpriteInstance, uv0)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<void*>(offsetof(SpriteInstance, color)));
+    renderer.vertex_attrib_divisor(0, 1);
+    renderer.vertex_attrib_divisor(1, 1);
+    renderer.vertex_attrib_divisor(2, 1);
+
+    // the backend has set the viewport to the whole framebuffer, which also gives us the framebuffer scale
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const ImVec2 scale(viewport[2] / batch.display_size.x, viewport[3] / batch.display_size.y);
+
+    const ImVec4& clip = command->ClipRect;
+    const ImVec2  clip_min((clip.x - batch.display_pos.x) * scale.x, (clip.y - batch.display_pos.y) * scale.y);
+    const ImVec2  clip_max((clip.z - batch.display_pos.x) * scale.x, (clip.w - batch.display_pos.y) * scale.y);
+    if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y) return;
+    glScissor(static_cast<GLint>(clip_min.x), static_cast<GLint>(viewport[3] - clip_max.y),
+              static_cast<GLsizei>(clip_max.x - clip_min.x), static_cast<GLsizei>(clip_max.y - clip_min.y));
+
+    // same projection as the backend's
+    const float L = batch.display_pos.x;
+    const float R = batch.display_pos.x + batch.display_size.x;
+    const float T = batch.display_pos.y;
+    const float B = batch.display_pos.y + batch.display_size.y;
+    const float projection[4][4] = {
+        {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+        {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f, 0.0f},
+        {(R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f},
+    };
+    glUseProgram(renderer.program);
+    glUniformMatrix4fv(renderer.location_projection, 1, GL_FALSE, &projection[0][0]);
+    glUniform1i(renderer.location_texture, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(batch.texture));
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(batch.instances.size()));
+    PROFILE_COUNTER_ADD("Sprite instances drawn", batch.instances.size());
+    (void)draw_list;
+}
+
+#else
+
+// no instancing renderer on this platform: callers always take the draw list path
+
+bool SpriteBatch::InitRenderer(const char*) {
+    return false;
+}
+
+void SpriteBatch::ShutdownRenderer() {}
+
+bool SpriteBatch::Available() {
+    return false;
+}
+
+SpriteBatch::~SpriteBatch() = default;
+
+void SpriteBatch::RenderCallback(const ImDrawList*, const ImDrawCmd*) {}
+
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "imgui/imgui.h"
+
+/**
+ * @brief One textured, tinted rectangle of a SpriteBatch (screen coordinates)
+ */
+struct SpriteInstance {
+    ImVec2 min;
+    ImVec2 max;
+    ImVec2 uv0;
+    ImVec2 uv1;
+    ImU32  color;
+};
+
+/**
+ * @brief Draws many sprites sharing one texture with a single instanced draw call.
+ *
+ * The instances stay in a GPU buffer between frames; only the range marked dirty since the last frame is uploaded.
+ * Draw() records an ImDrawList callback, so the batch renders in order with the rest of the window from inside the
+ * renderer backend (imgui_impl_opengl3). Without a renderer that supports it (Direct3D, the null renderer, or GL older
+ * than 3.3) Available() is false and callers draw their sprites through the draw list instead.
+ */
+class SpriteBatch {
+public:
+    SpriteBatch() = default;
+    ~SpriteBatch();
+
+    SpriteBatch(const SpriteBatch&)            = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+    /**
+     * @brief Create the GL objects. Called once after the renderer backend is initialized, with its GLSL version.
+     * @return true if instanced sprites are supported
+     */
+    static bool InitRenderer(const char* glsl_version);
+    static void ShutdownRenderer();
+
+    /// Whether batches can be drawn this frame (renderer initialized and batching enabled).
+    static bool Available();
+    static bool Enabled();
+    static void SetEnabled(bool enabled);
+
+    /**
+     * @brief Resize the instance array. Everything is uploaded again on the next draw.
+     */
+    void Resize(std::size_t count);
+    inline std::size_t     Size() const { return instances.size(); };
+    inline SpriteInstance& operator[](std::size_t index) { return instances[index]; };
+
+    /**
+     * @brief Mark instances as changed so they are uploaded on the next draw
+     */
+    void MarkDirty(std::size_t first, std::size_t count);
+
+    /**
+     * @brief Record the batch into a draw list, to be rendered with the given texture
+     */
+    void Draw(ImDrawList* draw_list, ImTextureID texture);
+
+private:
+    static void RenderCallback(const ImDrawList* draw_list, const ImDrawCmd* command);
+
+    std::vector<SpriteInstance> instances;
+    std::size_t                 dirty_first = 0;
+    std::size_t                 dirty_last  = 0; // one past the end; equal to dirty_first when clean
+
+    // set by Draw() for the render callback
+    ImTextureID texture = 0;
+    ImVec2      display_pos{0, 0};
+    ImVec2      display_size{0, 0};
+
+    // owned by the renderer
+    unsigned int gpu_buffer   = 0;
+    std::size_t  gpu_capacity = 0;
+};
@@ -0,0 +1,81 @@
+#include "classes/TextureAtlas.hpp"
+
+#include <cstdlib>
+
+#include "classes/AtlasCache.hpp"
+#include "classes/GpuTexture.hpp"
+#include "classes/Logger.hpp"
+#include "classes/MappedFile.hpp"
+#include "classes/Profiler.hpp"
+
+TextureAtlas& TextureAtlas::GetInstance() {
+    static TextureAtlas instance;
+    return instance;
+}
+
+const AtlasRegion* TextureAtlas::Find(const std::string& name) const {
+    const auto it = regions.find(name);
+    return it == regions.end() ? nullptr : &it->second;
+}
+
+void TextureAtlas::Release() {
+    GpuTexture::Destroy(texture);
+    texture = 0;
+    regions.clear();
+}
+
+bool TextureAtlas::Build(const std::filesystem::path& directory) {
+    PROFILE_ZONE("TextureAtlas::Build");
+    const auto start = Profiler::Clock::now();
+    Release();
+
+    // set TICTACTOE_NO_TEXTURE_CACHE to always decode the PNGs (e.g. to compare startup times)
+    const bool use_cache = std::getenv("TICTACTOE_NO_TEXTURE_CACHE") == nullptr;
+
+    const std::filesystem::path cache_path  = directory / AtlasCache::FILE_NAME;
+    const std::uint64_t         fingerprint = AtlasCache::Fingerprint(directory);
+
+    // the cached pixels are uploaded straight out of the mapping, so it stays open until the end of Build()
+    MappedFile  cache_file;
+    PackedAtlas atlas;
+    const bool  from_cache =
+        use_cache && cache_file.Open(cache_path) && AtlasCache::Read(cache_file.View(), fingerprint, atlas);
+    if (!from_cache) {
+        std::string error;
+        if (!AtlasCache::Pack(directory, atlas, error)) {
+            Logger::GetInstance().LogError("Atlas: {}", error);
+            return false;
+        }
+        if (use_cache) {
+            cache_file.Close();
+            if (!AtlasCache::Write(cache_path, atlas, fingerprint)) {
+                Logger::GetInstance().LogWarn("Atlas: could not write {}", cache_path.string());
+            }
+        }
+    }
+
+    texture = GpuTexture::Create(atlas.pixels, static_cast<int>(atlas.width), static_cast<int>(atlas.height));
+    if (!texture) {
+        Logger::GetInstance().LogError("Atlas: texture upload failed");
+        return false;
+    }
+
+    const float inv_width  = 1.0f / static_cast<float>(atlas.width);
+    const float inv_height = 1.0f / static_cast<float>(atlas.height);
+    regions.clear();
+    for (const PackedRegion& region : atlas.regions) {
+        regions[region.name] = AtlasRegion{
+            ImVec2(region.x * inv_width, region.y * inv_height),
+            ImVec2((region.x + region.width) * inv_width, (region.y + region.height) * inv_height),
+            ImVec2(static_cast<float>(region.width), static_cast<float>(region.height)),
+        };
+    }
+    white_uv = ImVec2((atlas.white_x + AtlasCache::WHITE_BLOCK * 0.5f) * inv_width,
+                      (atlas.white_y + AtlasCache::WHITE_BLOCK * 0.5f) * inv_height);
+    texture_size = ImVec2(static_cast<float>(atlas.width), static_cast<float>(atlas.height));
+
+    const double ms = std::chrono::duration<double, std::milli>(Profiler::Clock::now() - start).count();
+    Logger::GetInstance().LogInfo("Atlas: {} images in {}x{} from {} ({:.2f} ms)", regions.size(), atlas.width,
+                                  atlas.height, from_cache ? "cache" : "PNGs", ms);
+    return true;
+}
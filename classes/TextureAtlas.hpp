@@ -0,0 +1,61 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include "imgui/imgui.h"
+
+/**
+ * @brief Where one image lives inside the atlas texture
+ */
+struct AtlasRegion {
+    ImVec2 uv0;
+    ImVec2 uv1;
+    ImVec2 size; // in pixels
+};
+
+/**
+ * @brief Every image in resources/ packed into one texture at startup.
+ *
+ * Sprites whose image is in the atlas all share a texture, so imgui can merge a whole board (squares, pieces and
+ * highlights) into a single draw command instead of switching textures for every sprite. The packed pixels are kept in
+ * an on-disk cache (see AtlasCache), so a normal startup maps one file and uploads it without decoding anything.
+ */
+class TextureAtlas {
+    TextureAtlas() = default;
+
+public:
+    static TextureAtlas& GetInstance();
+
+    /**
+     * @brief Load the directory's atlas cache, or pack every .png in it when the cache is missing or stale, and upload
+     * it. Needs the rendering context to be current.
+     * @param directory Directory to scan (not recursive)
+     * @return true if the atlas was built
+     */
+    bool Build(const std::filesystem::path& directory);
+
+    /**
+     * @brief Find an image by file name (relative to the directory passed to Build)
+     * @return The image's region, or nullptr if it isn't in the atlas
+     */
+    const AtlasRegion* Find(const std::string& name) const;
+
+    /**
+     * @brief Free the atlas texture. Sprites still pointing at it must not be drawn afterwards.
+     */
+    void Release();
+
+    inline ImTextureID Texture() const { return texture; };
+    inline bool        IsBuilt() const { return texture != 0; };
+
+    /// UV of a solid white texel, for drawing flat colored shapes without leaving the atlas texture.
+    inline ImVec2 WhiteUV() const { return white_uv; };
+
+private:
+    ImTextureID                                  texture = 0;
+    ImVec2                                       white_uv{0, 0};
+    ImVec2                                       texture_size{0, 0};
+    std::unordered_map<std::string, AtlasRegion> regions;
+};
@@ -0,0 +1,115 @@
+#include "classes/TextureLoader.hpp"
+
+#include "classes/FrameScheduler.hpp"
+#include "classes/GpuTexture.hpp"
+#include "classes/Logger.hpp"
+#include "classes/Profiler.hpp"
+#include "classes/stb_image.h"
+
+LoadedTexture::~LoadedTexture() {
+    GpuTexture::Destroy(texture);
+}
+
+TextureLoader& TextureLoader::GetInstance() {
+    static TextureLoader instance;
+    return instance;
+}
+
+std::shared_ptr<const LoadedTexture> TextureLoader::Load(const std::filesystem::path& path) {
+    const std::string key = path.string();
+    if (const auto it = textures.find(key); it != textures.end()) {
+        it->second.unused_frames = 0;
+        return it->second.texture;
+    }
+
+    auto texture = std::make_shared<LoadedTexture>();
+    textures.emplace(key, CacheEntry{texture, 0});
+
+    int width = 0, height = 0, components = 0;
+    if (!stbi_info(key.c_str(), &width, &height, &components)) {
+        texture->state = LoadedTexture::State::Failed;
+        Logger::GetInstance().LogError("Failed to load texture: {}", key);
+        return texture;
+    }
+    texture->size = ImVec2(static_cast<float>(width), static_cast<float>(height));
+
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.Submit([this, texture, key] {
+        PROFILE_ZONE("TextureLoader decode");
+        Decoded result;
+        result.target = texture;
+        result.path   = key;
+        result.pixels = stbi_load(key.c_str(), &result.width, &result.height, nullptr, 4);
+        {
+            std::lock_guard lock(decoded_mutex);
+            decoded.push_back(result);
+        }
+        FrameScheduler::GetInstance().RequestFrame();
+    });
+    return texture;
+}
+
+void TextureLoader::Update() {
+    UploadPending();
+    EvictUnused();
+}
+
+void TextureLoader::Clear() {
+    textures.clear();
+}
+
+void TextureLoader::EvictUnused() {
+    for (auto it = textures.begin(); it != textures.end();) {
+        CacheEntry& entry = it->second;
+        // a texture still loading is also referenced by its decode task
+        if (entry.texture.use_count() > 1 || entry.texture->state == LoadedTexture::State::Loading) {
+            entry.unused_frames = 0;
+        }
+        else if (++entry.unused_frames > EVICT_AFTER_FRAMES) {
+            it = textures.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
+void TextureLoader::UploadPending() {
+    if (pending.load(std::memory_order_relaxed) == 0) return;
+
+    PROFILE_ZONE("TextureLoader::UploadPending");
+    const auto  start    = Profiler::Clock::now();
+    std::size_t uploaded = 0;
+
+    while (true) {
+        Decoded image;
+        {
+            std::lock_guard lock(decoded_mutex);
+            if (decoded.empty()) break;
+            if (uploaded > 0) {
+                const double elapsed_ms =
+                    std::chrono::duration<double, std::milli>(Profiler::Clock::now() - start).count();
+                if (uploaded >= UPLOAD_BUDGET_BYTES || elapsed_ms >= UPLOAD_BUDGET_MS) {
+                    // over budget, the rest waits for the next frame
+                    FrameScheduler::GetInstance().RequestFrame();
+                    break;
+                }
+            }
+            image = decoded.front();
+            decoded.pop_front();
+        }
+        pending.fetch_sub(1, std::memory_order_relaxed);
+
+        LoadedTexture& target = *image.target;
+        if (image.pixels) {
+            target.texture = GpuTexture::Create(image.pixels, image.width, image.height);
+            target.size    = ImVec2(static_cast<float>(image.width), static_cast<float>(image.height));
+            stbi_image_free(image.pixels);
+            uploaded += static_cast<std::size_t>(image.width) * image.height * 4;
+        }
+        target.state = target.texture ? LoadedTexture::State::Ready : LoadedTexture::State::Failed;
+        if (!target.texture) {
+            Logger::GetInstance().LogError("Failed to load texture: {}", image.path);
+        }
+    }
+    PROFILE_COUNTER_ADD("Texture bytes uploaded", uploaded);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "classes/ThreadPool.hpp"
+#include "imgui/imgui.h"
+
+/**
+ * @brief A texture that may still be loading. Only touched on the render thread.
+ *
+ * Owned through shared_ptr by the sprites using it and by the TextureLoader's cache; the GPU texture is freed with the
+ * last reference.
+ */
+struct LoadedTexture {
+    enum class State { Loading, Ready, Failed };
+
+    LoadedTexture() = default;
+    ~LoadedTexture();
+
+    LoadedTexture(const LoadedTexture&)            = delete;
+    LoadedTexture& operator=(const LoadedTexture&) = delete;
+
+    State       state   = State::Loading;
+    ImTextureID texture = 0;
+    ImVec2      size{0, 0}; // known as soon as the file header has been read, so layout doesn't wait for the pixels
+};
+
+/**
+ * @brief Decodes image files on a worker pool and uploads them on the render thread, a few per frame.
+ *
+ * Load() only reads the image header and returns immediately; the sprite keeps a handle and draws a placeholder until
+ * the texture is Ready. Each file is loaded once and the texture shared by every sprite that asks for it. Textures no
+ * sprite has used for EVICT_AFTER_FRAMES frames are dropped from the cache (and freed).
+ */
+class TextureLoader {
+    TextureLoader() = default;
+
+public:
+    /// Stop uploading for this frame once this many bytes have been uploaded...
+    static constexpr std::size_t UPLOAD_BUDGET_BYTES = 4u << 20;
+    /// ...or this much time has been spent (at least one texture is always uploaded).
+    static constexpr double UPLOAD_BUDGET_MS = 2.0;
+    /// Frames a texture stays cached with no sprite using it, so a board reset doesn't reload everything.
+    static constexpr unsigned int EVICT_AFTER_FRAMES = 600;
+
+    static TextureLoader& GetInstance();
+
+    /**
+     * @brief Start loading an image, or return the one already loaded/loading. Render thread only.
+     * @return The texture handle; Failed straight away if the file can't be read
+     */
+    std::shared_ptr<const LoadedTexture> Load(const std::filesystem::path& path);
+
+    /**
+     * @brief Upload decoded images within the per-frame budget and evict unused textures. Called once per frame on the
+     * render thread.
+     */
+    void Update();
+
+    /**
+     * @brief Drop every cached texture (textures still held by sprites live on until those let go). Render thread only.
+     */
+    void Clear();
+
+    /// Images requested but not uploaded yet.
+    inline std::size_t PendingCount() const { return pending.load(std::memory_order_relaxed); };
+    /// Textures in the cache, used or not.
+    inline std::size_t CachedCount() const { return textures.size(); };
+
+private:
+    struct Decoded {
+        std::shared_ptr<LoadedTexture> target;
+        std::string                    path;
+        unsigned char*                 pixels = nullptr; // stbi_image_free'd after the upload
+        int                            width  = 0;
+        int                            height = 0;
+    };
+
+    struct CacheEntry {
+        std::shared_ptr<LoadedTexture> texture;
+        unsigned int                   unused_frames = 0;
+    };
+
+    void UploadPending();
+    void EvictUnused();
+
+    std::unordered_map<std::string, CacheEntry> textures;
+    std::atomic<std::size_t>                                         pending{0};
+
+    std::mutex          decoded_mutex;
+    std::deque<Decoded> decoded;
+
+    // declared last so the workers are joined before the queue they write to is destroyed
+    ThreadPool pool{"Texture loader", 2};
+};
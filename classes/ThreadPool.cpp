@@ -0,0 +1,99 @@
+#include "classes/ThreadPool.hpp"
+
+#include <algorithm>
+
+#include "classes/Tracer.hpp"
+
+namespace {
+    // the pool (and its queue) the current thread works for, so tasks submitted by a task stay on that worker
+    thread_local const ThreadPool* current_pool  = nullptr;
+    thread_local std::size_t       current_queue = 0;
+} // namespace
+
+ThreadPool::ThreadPool(const std::string& name, std::size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency()) - 1;
+        thread_count = std::max<std::size_t>(thread_count, 1);
+    }
+
+    queues.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    threads.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; i++) {
+        threads.emplace_back(&ThreadPool::WorkerLoop, this, i, name + " " + std::to_string(i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(sleep_mutex);
+        stopping = true;
+    }
+    for (auto& queue : queues) {
+        std::lock_guard lock(queue->mutex);
+        queue->tasks.clear();
+    }
+    wake.notify_all();
+    for (auto& thread : threads) thread.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    const std::size_t index =
+        current_pool == this ? current_queue : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        // counted under the sleep mutex, so a worker about to sleep either sees the task or gets the notification, and
+        // before the task is queued, so taking it can't bring the count below zero
+        std::lock_guard lock(sleep_mutex);
+        queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::PopTask(const std::size_t index, std::function<void()>& task) {
+    {
+        WorkerQueue&    own = *queues[index];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    for (std::size_t i = 1; i < queues.size(); i++) {
+        WorkerQueue&    victim = *queues[(index + i) % queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            // the newest task, the one its owner would get to last
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(const std::size_t index, std::string name) {
+    Tracer::GetInstance().SetThreadName(name);
+    current_pool  = this;
+    current_queue = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (PopTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock lock(sleep_mutex);
+        wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_relaxed) > 0; });
+        if (stopping) return;
+    }
+}
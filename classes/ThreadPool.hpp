@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed set of worker threads running submitted tasks, balancing the load by work stealing.
+ *
+ * Every worker has its own queue. Tasks submitted from outside the pool are dealt to the queues in turn, tasks a
+ * worker submits itself go to its own queue. A worker runs its own queue in FIFO order and, once that is empty, steals
+ * the newest task of another worker, so a few slow tasks don't leave the other workers idle behind them.
+ *
+ * Destroying the pool finishes the tasks that are already running, drops the ones still queued and joins the threads.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param name Prefix of the worker names shown in traces
+     * @param thread_count Number of workers; 0 picks one less than the hardware thread count (at least one)
+     */
+    explicit ThreadPool(const std::string& name, std::size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task to run on one of the workers. Safe to call from any thread.
+     */
+    void Submit(std::function<void()> task);
+
+    inline std::size_t ThreadCount() const { return threads.size(); };
+
+private:
+    struct WorkerQueue {
+        std::mutex                        mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(std::size_t index, std::string name);
+    bool PopTask(std::size_t index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::atomic<std::size_t>                  next_queue{0};
+    std::atomic<std::size_t>                  queued{0};
+
+    // idle workers sleep here until something is queued
+    std::mutex              sleep_mutex;
+    std::condition_variable wake;
+    bool                    stopping = false;
+
+    std::vector<std::thread> threads;
+};
@@ -1,6 +1,13 @@
 #include "TicTacToe.h"
 
+#include "classes/FrameScheduler.hpp"
 #include "classes/Logger.hpp"
+#include "classes/Profiler.hpp"
+#include "classes/ThreadPool.hpp"
+#include "classes/TicTacToeAI.hpp"
+
+#include <chrono>
+#include <memory>
 
 // -----------------------------------------------------------------------------
 // TicTacToe.cpp
@@ -38,12 +45,24 @@
  * - I added a bit of padding to the top of the grid (24 pixels) so that the grid wasn't overlapping with the imgui window title.
  */
 
-const int AI_PLAYER    = 1;  // index of the AI player (O)
-const int HUMAN_PLAYER = -1; // index of the human player (X)
+const int AI_PLAYER = 1; // index of the AI player (O)
+
+// the searches of every game share these workers, instead of a thread per search
+static ThreadPool& AIThreadPool() {
+    static ThreadPool pool("AI");
+    return pool;
+}
 
 TicTacToe::TicTacToe() {}
 
-TicTacToe::~TicTacToe() {}
+// stopGame() waits for a search still running (it refers to this game) and hands the board's bits to ~Game to free
+TicTacToe::~TicTacToe() { stopGame(); }
+
+void TicTacToe::setAIConfig(const AIConfig& config, const unsigned int seed) {
+    cancelAI();
+    _aiConfig = config;
+    _aiRandom.seed(seed);
+}
 
 // -----------------------------------------------------------------------------
 // make an X or an O
@@ -68,9 +87,10 @@ void TicTacToe::setUpBoard() {
     // finally we should call startGame to get everything going
 
     setNumberOfPlayers(2);
-    setAIPlayer(1);
+    setAIPlayer(AI_PLAYER);
 
     _gameOptions.rowX = _gameOptions.rowY = 3;
+    setBoardGeometry(ImVec2(0.0f, 24.0f), ImVec2(100.0f, 100.0f));
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
             _grid[i][j].initHolder(ImVec2(j * 100.0f, i * 100.0f + 24.0f), "square.png", j, i);
@@ -102,7 +122,9 @@ bool TicTacToe::actionForEmptyHolder(BitHolder* holder) {
     //    - Assign it to the holder: holder->setBit(newBit);
     if (!getCurrentPlayer()) return false;
 
-    Bit* bit = PieceForPlayer(getCurrentPlayer()->playerNumber());
+    // a bit from an earlier game already has the right texture and owner
+    Bit* bit = reuseBit(getCurrentPlayer());
+    if (!bit) bit = PieceForPlayer(getCurrentPlayer()->playerNumber());
     bit->setPosition(holder->getPosition());
     holder->setBit(bit);
     Logger::GetInstance().LogGameEventInfo("Player {} placed bit at ({}, {})", getCurrentPlayer()->playerNumber(),
@@ -127,13 +149,26 @@ bool TicTacToe::canBitMoveFromTo(Bit* bit, BitHolder* src, BitHolder* dst) {
 // free all the memory used by the game on the heap
 //
 void TicTacToe::stopGame() {
+    cancelAI();
+
     // clear out the board
-    // loop through the 3x3 array and call destroyBit on each square
+    // loop through the 3x3 array and recycle each square's bit for the next game
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
-            _grid[i][j].destroyBit();
+            recycleBit(_grid[i][j]);
         }
     }
+    markStateChanged();
+}
+
+//
+// let any running AI search finish and throw its move away, so it can't land on a board it wasn't searched for
+//
+void TicTacToe::cancelAI() {
+    if (_aiMove.valid()) {
+        _aiMove.wait();
+        _aiMove = {};
+    }
 }
 
 //
@@ -196,8 +231,7 @@ Player* TicTacToe::boardCheckHelper(bool* isDraw) {
         if (isDraw) {
             *isDraw = false; // a player has won, not a draw
         }
-        Logger::GetInstance().LogGameEventInfo("Detected win by player {} with triple ({}, {}, {})", p->playerNumber(),
-                                               triple[0], triple[1], triple[2]);
+        // not logged here: every undo, redo and seek checks the board again, Game::endTurn() logs the win once
         return p;
     }
 
@@ -251,6 +285,11 @@ bool TicTacToe::checkForDraw() {
     return isDraw;
 }
 
+Player* TicTacToe::checkForResult(bool& isDraw) {
+    // the winner and the draw in a single pass over the triples
+    return boardCheckHelper(&isDraw);
+}
+
 //
 // state strings
 //
@@ -263,6 +302,8 @@ std::string TicTacToe::initialStateString() {
 // we will read the state string and store it in each turn object
 //
 std::string TicTacToe::stateString() const {
+    PROFILE_ZONE("TicTacToe::stateString");
+
     // return a string representing the current state of the board
     // the string should be 9 characters long, one for each square
     // each character should be '0' for empty, '1' for player 1 (X), and '2' for player 2 (O)
@@ -321,107 +362,51 @@ void TicTacToe::setStateString(const std::string& s) {
         int        x      = i % 3;
         int        y      = i / 3;
         BitHolder& holder = _grid[y][x];
-        if (pn == 0) {
-            holder.destroyBit();
-        }
-        else {
-            Bit* bit = PieceForPlayer(pn);
+        recycleBit(holder);
+        if (pn != 0) {
+            // the state string counts players from 1
+            Bit* bit = reuseBit(getPlayerAt(pn - 1));
+            if (!bit) bit = PieceForPlayer(pn - 1);
             bit->setPosition(holder.getPosition());
             holder.setBit(bit);
         }
     }
 
+    markStateChanged();
     Logger::GetInstance().LogGameEventInfo("Game state set via string \"{}\"", s);
 }
 
-static int negamax(std::string& state, const int depth, const int player_color);
-
 //
 // this is the function that will be called by the AI
 //
 void TicTacToe::updateAI() {
-    auto state       = stateString();
-    int  best_move   = -1000;
-    int  best_square = -1;
-
-    for (int i = 0; i < 9; i++) {
-        if (state[i] != '0') continue;
-
-        state[i]   = '2';
-        const int result = -negamax(state, 0, HUMAN_PLAYER);
-        Logger::GetInstance().LogGameEventInfo("Space {} has value {}", i, result);
-        if (result > best_move) {
-            best_move   = result;
-            best_square = i;
-        }
-        state[i] = '0';
+    PROFILE_ZONE("TicTacToe::updateAI");
+
+    // the search runs on a worker thread so it never stalls a frame, we just check for the result every frame
+    if (!_aiMove.valid()) {
+        if (gameOver()) return; // nothing left to play for
+        const std::string state = stateString();
+        const char        piece = static_cast<char>('1' + getCurrentPlayer()->playerNumber());
+
+        // std::function needs a copyable task
+        auto search = std::make_shared<std::packaged_task<int()>>([this, state, piece]() {
+            const int square = TicTacToeAI::ChooseMove(state, piece, _aiConfig, _aiRandom);
+            FrameScheduler::GetInstance().RequestFrame();
+            return square;
+        });
+        _aiMove = search->get_future();
+        AIThreadPool().Submit([search]() { (*search)(); });
+        return;
     }
 
+    if (_aiMove.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+    const int best_square = _aiMove.get();
     if (best_square != -1) {
         int x = best_square % 3;
         int y = best_square / 3;
-        actionForEmptyHolder(&getHolderAt(x, y));
-        endTurn();
-    }
-}
-
-static char check_winner(const std::string& state) {
-    static constexpr int WINNING_TRIPLES[8][3] = {
-        {0, 1, 2},
-        {3, 4, 5},
-        {6, 7, 8},
-        {0, 3, 6},
-        {1, 4, 7},
-        {2, 5, 8},
-        {0, 4, 8},
-        {2, 4, 6},
-    };
-
-    // Check for the winner over the triples. We also track a draw (indicated by a return value of 'd').
-    bool full = true;
-    for (unsigned i = 0; i < 8; i++) {
-        const int* triple = WINNING_TRIPLES[i];
-        const char s0     = state.at(triple[0]);
-        if (s0 == '0') {
-            full = false;
-            continue;
-        }
-        const char s1 = state.at(triple[1]);
-        const char s2 = state.at(triple[2]);
-        if (s0 == s1 && s1 == s2) {
-            return s0;
-        }
+        BitHolder& holder = getHolderAt(x, y);
+        actionForEmptyHolder(&holder);
+        endTurn(&holder);
     }
-
-    for (unsigned i = 0; full && i < 9; i++) {
-        if (state[i] == '0') full = false;
-    }
-
-    if (full) {
-        return 'd';
-    }
-
-    // no winner
-    return '0';
-}
-
-
-static int negamax(std::string& state, const int depth, const int player_color) {
-    if (const char active_winner = check_winner(state); active_winner != '0') {
-        // active_winner == '0' when the state is not a terminal state.
-        if (depth <= 2) {
-            Logger::GetInstance().LogGameEventInfo("Win within 2: {}", active_winner);
-        }
-        return active_winner == 'd' ? 0 : -10;
-    }
-
-    int value = -1000;
-    for (int i = 0; i < 9; i++) {
-        if (state[i] != '0') continue;
-        state[i] = player_color == HUMAN_PLAYER ? '1' : '2';
-        value    = std::max(value, -negamax(state, depth + 1, -player_color));
-        state[i] = '0';
-    }
-
-    return value;
 }
@@ -1,6 +1,10 @@
 #pragma once
 #include "Game.h"
 #include "Square.h"
+#include "TicTacToeAI.hpp"
+
+#include <future>
+#include <random>
 
 //
 // the classic game of tic tac toe
@@ -19,6 +23,7 @@ public:
 
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
+    Player*     checkForResult(bool& isDraw) override;
     std::string initialStateString() override;
     std::string stateString() const override;
     void        setStateString(const std::string& s) override;
@@ -28,7 +33,10 @@ public:
     void        stopGame() override;
 
     void       updateAI() override;
+    void       cancelAI() override;
     bool       gameHasAI() override { return true; }
+    // how the AI plays its moves (perfect play by default), and the seed of its random moves
+    void       setAIConfig(const AIConfig& config, unsigned int seed);
     BitHolder& getHolderAt(const int x, const int y) override { return _grid[y][x]; }
 private:
     Bit*    PieceForPlayer(const int playerNumber);
@@ -37,4 +45,9 @@ private:
     Player* boardCheckHelper(bool* isDraw);
 
     Square _grid[3][3];
+
+    // best square for the AI, searched for on a worker thread (invalid when no search is running)
+    std::future<int> _aiMove;
+    AIConfig         _aiConfig;
+    std::mt19937     _aiRandom; // only used by the one search running at a time
 };
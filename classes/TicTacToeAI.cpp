@@ -0,0 +1,255 @@
+#include "classes/TicTacToeAI.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "classes/Logger.hpp"
+#include "classes/Profiler.hpp"
+#include "classes/ThreadPool.hpp"
+
+namespace {
+    inline char Opponent(const char player) {
+        return player == '1' ? '2' : '1';
+    }
+
+    int Negamax(std::string& state, const int depth, const int max_depth, const char player, const bool logged,
+                std::uint64_t& nodes) {
+        nodes++;
+        if (const char active_winner = TicTacToeAI::Winner(state); active_winner != '0') {
+            // active_winner == '0' when the state is not a terminal state.
+            if (logged && depth <= 2) {
+                Logger::GetInstance().LogGameEventInfo("Win within 2: {}", active_winner);
+            }
+            // the side to move never made the winning move, so a win is always a loss here
+            return active_winner == 'd' ? 0 : -10;
+        }
+        // past the search horizon nothing is known about the position
+        if (max_depth >= 0 && depth >= max_depth) return 0;
+
+        int value = -1000;
+        for (int i = 0; i < 9; i++) {
+            if (state[i] != '0') continue;
+            state[i] = player;
+            value    = std::max(value, -Negamax(state, depth + 1, max_depth, Opponent(player), logged, nodes));
+            state[i] = '0';
+        }
+
+        return value;
+    }
+
+    // The batch search keeps a board as one 9-bit mask of squares per side and indexes the transposition table by the
+    // board's base-3 code (the state string read as a number, least significant square first) and the side to move.
+    constexpr std::uint16_t FULL_BOARD               = 0x1ff;
+    constexpr std::uint16_t WINNING_LINES[8]         = {0x007, 0x038, 0x1c0, 0x049, 0x092, 0x124, 0x111, 0x054};
+    constexpr int           POWERS_OF_THREE[9]       = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+    constexpr int           BOARD_CODES              = 19683; // 3^9
+    constexpr std::size_t   POSITIONS_PER_BATCH_TASK = 4096;  // 40 KB of positions in, 8 KB of moves out
+
+    /**
+     * @brief Exact values of positions under perfect play, for the side to move.
+     *
+     * A value never changes once known, so the table is never cleared and every thread shares it without a lock: two
+     * threads that miss the same entry both compute the same value, and whichever store lands last is just as right.
+     * At a byte per entry the whole table is under 40 KB and stays in cache.
+     */
+    class TranspositionTable {
+    public:
+        static constexpr std::int8_t UNKNOWN = -128;
+
+        static TranspositionTable& GetInstance() {
+            static TranspositionTable instance;
+            return instance;
+        }
+
+        inline std::atomic<std::int8_t>& At(const int code, const int side) { return values[code * 2 + side]; };
+
+    private:
+        TranspositionTable() {
+            for (std::atomic<std::int8_t>& value : values) value.store(UNKNOWN, std::memory_order_relaxed);
+        }
+
+        std::atomic<std::int8_t> values[BOARD_CODES * 2];
+    };
+
+    inline bool HasLine(const std::uint16_t squares) {
+        for (const std::uint16_t line : WINNING_LINES) {
+            if ((squares & line) == line) return true;
+        }
+        return false;
+    }
+
+    // value for the side to move (side 0 is player '1'), who holds mine while the other side holds theirs
+    int SolvedValue(const std::uint16_t mine, const std::uint16_t theirs, const int code, const int side,
+                    TranspositionTable& table) {
+        std::atomic<std::int8_t>& entry = table.At(code, side);
+        if (const std::int8_t known = entry.load(std::memory_order_relaxed); known != TranspositionTable::UNKNOWN) {
+            return known;
+        }
+
+        int value;
+        if (HasLine(theirs)) value = -10;
+        else if (HasLine(mine)) value = 10;
+        else if ((mine | theirs) == FULL_BOARD) value = 0;
+        else {
+            value = -1000;
+            for (int i = 0; i < 9; i++) {
+                const std::uint16_t square = static_cast<std::uint16_t>(1u << i);
+                if ((mine | theirs) & square) continue;
+                value = std::max(value, -SolvedValue(theirs, mine | square, code + (side + 1) * POWERS_OF_THREE[i],
+                                                     side ^ 1, table));
+            }
+        }
+
+        entry.store(static_cast<std::int8_t>(value), std::memory_order_relaxed);
+        return value;
+    }
+
+    TicTacToeAI::Move SearchPosition(const TicTacToeAI::Position& position, TranspositionTable& table) {
+        std::uint16_t squares[2] = {0, 0};
+        int           code       = 0;
+        for (int i = 0; i < 9; i++) {
+            const char cell = position.cells[i];
+            if (cell != '1' && cell != '2') continue;
+            squares[cell - '1'] |= static_cast<std::uint16_t>(1u << i);
+            code += (cell - '0') * POWERS_OF_THREE[i];
+        }
+        const int           side   = position.player == '2' ? 1 : 0;
+        const std::uint16_t mine   = squares[side];
+        const std::uint16_t theirs = squares[side ^ 1];
+
+        if (HasLine(theirs) || HasLine(mine) || (mine | theirs) == FULL_BOARD) {
+            return {-1, static_cast<std::int8_t>(SolvedValue(mine, theirs, code, side, table))};
+        }
+
+        int best_value  = -1000;
+        int best_square = -1;
+        for (int i = 0; i < 9; i++) {
+            const std::uint16_t square = static_cast<std::uint16_t>(1u << i);
+            if ((mine | theirs) & square) continue;
+            const int value =
+                -SolvedValue(theirs, mine | square, code + (side + 1) * POWERS_OF_THREE[i], side ^ 1, table);
+            if (value > best_value) {
+                best_value  = value;
+                best_square = i;
+            }
+        }
+        table.At(code, side).store(static_cast<std::int8_t>(best_value), std::memory_order_relaxed);
+        return {static_cast<std::int8_t>(best_square), static_cast<std::int8_t>(best_value)};
+    }
+
+    void SearchPositions(const std::span<const TicTacToeAI::Position> positions,
+                         const std::span<TicTacToeAI::Move>           moves) {
+        PROFILE_ZONE("TicTacToe AI batch");
+        TranspositionTable& table = TranspositionTable::GetInstance();
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            moves[i] = SearchPosition(positions[i], table);
+        }
+        PROFILE_COUNTER_ADD("batched positions", positions.size());
+    }
+} // namespace
+
+char TicTacToeAI::Winner(const std::string& state) {
+    static constexpr int WINNING_TRIPLES[8][3] = {
+        {0, 1, 2},
+        {3, 4, 5},
+        {6, 7, 8},
+        {0, 3, 6},
+        {1, 4, 7},
+        {2, 5, 8},
+        {0, 4, 8},
+        {2, 4, 6},
+    };
+
+    // Check for the winner over the triples. We also track a draw (indicated by a return value of 'd').
+    bool full = true;
+    for (unsigned i = 0; i < 8; i++) {
+        const int* triple = WINNING_TRIPLES[i];
+        const char s0     = state.at(triple[0]);
+        if (s0 == '0') {
+            full = false;
+            continue;
+        }
+        const char s1 = state.at(triple[1]);
+        const char s2 = state.at(triple[2]);
+        if (s0 == s1 && s1 == s2) {
+            return s0;
+        }
+    }
+
+    for (unsigned i = 0; full && i < 9; i++) {
+        if (state[i] == '0') full = false;
+    }
+
+    if (full) {
+        return 'd';
+    }
+
+    // no winner
+    return '0';
+}
+
+int TicTacToeAI::BestMove(std::string state, const char player, const int depth, const bool logged) {
+    PROFILE_ZONE("TicTacToe AI search");
+
+    int           best_move   = -1000;
+    int           best_square = -1;
+    std::uint64_t nodes       = 0; // counted locally and published once, negamax is too hot for an atomic per node
+
+    for (int i = 0; i < 9; i++) {
+        if (state[i] != '0') continue;
+
+        state[i]         = player;
+        const int result = -Negamax(state, 0, depth, Opponent(player), logged, nodes);
+        if (logged) Logger::GetInstance().LogGameEventInfo("Space {} has value {}", i, result);
+        if (result > best_move) {
+            best_move   = result;
+            best_square = i;
+        }
+        state[i] = '0';
+    }
+
+    PROFILE_COUNTER_ADD("negamax nodes", nodes);
+    PROFILE_HISTOGRAM_RECORD("negamax nodes per search", nodes);
+
+    return best_square;
+}
+
+int TicTacToeAI::ChooseMove(const std::string& state, const char player, const AIConfig& config,
+                            std::mt19937& random) {
+    if (config.blunder > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(random) < config.blunder) {
+        int open[9];
+        int count = 0;
+        for (int i = 0; i < 9; i++) {
+            if (state[i] == '0') open[count++] = i;
+        }
+        if (count > 0) return open[std::uniform_int_distribution<int>(0, count - 1)(random)];
+    }
+    return BestMove(state, player, config.depth, config.logged);
+}
+
+void TicTacToeAI::BestMoves(const std::span<const Position> positions, const std::span<Move> moves, ThreadPool* pool) {
+    const std::size_t count = std::min(positions.size(), moves.size());
+    if (!pool || count <= POSITIONS_PER_BATCH_TASK) {
+        SearchPositions(positions.first(count), moves.first(count));
+        return;
+    }
+
+    std::mutex              mutex;
+    std::condition_variable done;
+    std::size_t             remaining = (count + POSITIONS_PER_BATCH_TASK - 1) / POSITIONS_PER_BATCH_TASK;
+    for (std::size_t first = 0; first < count; first += POSITIONS_PER_BATCH_TASK) {
+        const std::size_t size = std::min(POSITIONS_PER_BATCH_TASK, count - first);
+        pool->Submit([&, first, size] {
+            SearchPositions(positions.subspan(first, size), moves.subspan(first, size));
+
+            std::lock_guard lock(mutex);
+            if (--remaining == 0) done.notify_one();
+        });
+    }
+
+    std::unique_lock lock(mutex);
+    done.wait(lock, [&] { return remaining == 0; });
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+
+class ThreadPool;
+
+/**
+ * @brief How an AI player plays: how far it searches and how often it ignores the search
+ */
+struct AIConfig {
+    std::string name    = "perfect";
+    int         depth   = -1;  // plies searched past the move itself, -1 for the whole game tree
+    double      blunder = 0.0; // chance of playing a random open square instead of the searched one
+    bool        logged  = true; // log each square's value to the game log, too slow for many games at once
+};
+
+/**
+ * @brief Tic-tac-toe move search on state strings (see TicTacToe::stateString()).
+ *
+ * Nothing here touches a Game, and searches can run on any number of threads at once. Two things are shared:
+ * BestMove() logs each square's value through the global Logger unless it's called with logged=false (many games at
+ * once would flood the log), and BestMoves() keeps one process-wide transposition table. That table only ever holds
+ * exact values, in relaxed atomics, so threads that race on an entry just store the same value.
+ */
+namespace TicTacToeAI {
+    /**
+     * @return '1' or '2' for the winner, 'd' for a draw, or '0' while the game goes on
+     */
+    char Winner(const std::string& state);
+
+    /**
+     * @brief Negamax search over every open square
+     * @param player The side to move, '1' or '2'
+     * @param depth Plies searched past the move itself, -1 for the whole game tree
+     * @param logged Log each square's value (and wins found within two plies) at Info
+     * @return The best square (the first one, between equally good squares), or -1 if no square is open
+     */
+    int BestMove(std::string state, char player, int depth = -1, bool logged = true);
+
+    /**
+     * @brief The square an AI player with this config takes
+     */
+    int ChooseMove(const std::string& state, char player, const AIConfig& config, std::mt19937& random);
+
+    /**
+     * @brief A position to search in a batch, a state string's cells and the side to move
+     */
+    struct Position {
+        std::array<char, 9> cells;  // '0' for an empty square, '1' or '2' for a taken one
+        char                player; // '1' or '2'
+    };
+
+    /**
+     * @brief What a batch search found for one position
+     */
+    struct Move {
+        std::int8_t square; // the best square (the first one, between equally good squares), -1 if the game is over
+        std::int8_t value;  // 10 for a win, 0 for a draw, -10 for a loss of the side to move under perfect play
+    };
+
+    /**
+     * @brief Search the whole game tree of every position, as BestMove(state, player) does, without logging.
+     *
+     * Every search shares one transposition table of exact position values for the whole process, so after a few
+     * thousand positions a search is mostly table lookups. With a pool the positions are cut into contiguous chunks,
+     * one task each, and the call waits for all of them; it must not be called from one of the pool's own tasks.
+     *
+     * @param moves Receives the move for positions[i] at moves[i], must be at least as long as positions
+     * @param pool Workers to spread the batch over, or nullptr to search on the calling thread
+     */
+    void BestMoves(std::span<const Position> positions, std::span<Move> moves, ThreadPool* pool = nullptr);
+} // namespace TicTacToeAI
@@ -0,0 +1,130 @@
+#include "classes/Tracer.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+Tracer::Tracer() : epoch(std::chrono::steady_clock::now()) {}
+
+Tracer& Tracer::GetInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::ThreadBuffer::~ThreadBuffer() {
+    for (Chunk* chunk = head; chunk;) {
+        Chunk* next = chunk->next.load(std::memory_order_relaxed);
+        delete chunk;
+        chunk = next;
+    }
+}
+
+void Tracer::Start() {
+    if (enabled.load(std::memory_order_relaxed)) return;
+    session.fetch_add(1, std::memory_order_acq_rel);
+    enabled.store(true, std::memory_order_release);
+}
+
+void Tracer::Stop() {
+    enabled.store(false, std::memory_order_release);
+}
+
+void Tracer::SetThreadName(const std::string& name) {
+    ThreadBuffer*   buffer = LocalBuffer();
+    std::lock_guard lock(registry_mutex);
+    buffer->thread_name = name;
+}
+
+std::uint64_t Tracer::DroppedEvents() const {
+    std::lock_guard lock(registry_mutex);
+    std::uint64_t   dropped = 0;
+    for (const auto& buffer : buffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+Tracer::ThreadBuffer* Tracer::LocalBuffer() {
+    thread_local ThreadBuffer* local = nullptr;
+    if (!local) [[unlikely]] {
+        auto buffer  = std::make_unique<ThreadBuffer>();
+        buffer->head = buffer->tail = new Chunk;
+
+        std::lock_guard lock(registry_mutex);
+        buffer->thread_id   = static_cast<std::uint32_t>(buffers.size() + 1);
+        buffer->thread_name = "thread " + std::to_string(buffer->thread_id);
+        local               = buffers.emplace_back(std::move(buffer)).get();
+    }
+    return local;
+}
+
+void Tracer::Record(const char* name, const char phase) {
+    const auto    now    = std::chrono::steady_clock::now();
+    ThreadBuffer* buffer = LocalBuffer();
+
+    // first event of a new session: rewind onto the existing chunks before announcing the session to Flush()
+    const std::uint32_t current_session = session.load(std::memory_order_acquire);
+    if (buffer->session.load(std::memory_order_relaxed) != current_session) [[unlikely]] {
+        buffer->published.store(0, std::memory_order_release);
+        buffer->tail       = buffer->head;
+        buffer->tail_count = 0;
+        buffer->session.store(current_session, std::memory_order_release);
+    }
+
+    const std::size_t count = buffer->published.load(std::memory_order_relaxed);
+    if (count >= MAX_EVENTS_PER_THREAD) [[unlikely]] {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (buffer->tail_count == CHUNK_EVENTS) [[unlikely]] {
+        Chunk* next = buffer->tail->next.load(std::memory_order_relaxed);
+        if (!next) {
+            next = new Chunk;
+            buffer->tail->next.store(next, std::memory_order_release);
+        }
+        buffer->tail       = next;
+        buffer->tail_count = 0;
+    }
+
+    buffer->tail->events[buffer->tail_count++] = TraceEvent{
+        name, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch).count()),
+        phase};
+    buffer->published.store(count + 1, std::memory_order_release);
+}
+
+bool Tracer::Flush(const std::filesystem::path& path) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out) return false;
+
+    const std::uint32_t current_session = session.load(std::memory_order_acquire);
+
+    std::lock_guard lock(registry_mutex);
+
+    char line[256];
+    bool first = true;
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for (const auto& buffer : buffers) {
+        // buffers that haven't recorded since Start() still hold a previous session
+        if (buffer->session.load(std::memory_order_acquire) != current_session) continue;
+        const std::size_t count = buffer->published.load(std::memory_order_acquire);
+
+        std::snprintf(line, sizeof(line),
+                      "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+                      first ? "" : ",\n", buffer->thread_id, buffer->thread_name.c_str());
+        out << line;
+        first = false;
+
+        const Chunk* chunk = buffer->head;
+        for (std::size_t i = 0; i < count; i++) {
+            if (i > 0 && i % CHUNK_EVENTS == 0) chunk = chunk->next.load(std::memory_order_acquire);
+
+            const TraceEvent& event = chunk->events[i % CHUNK_EVENTS];
+            std::snprintf(line, sizeof(line), ",\n{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %u}",
+                          event.name, event.phase, static_cast<double>(event.timestamp_ns) / 1000.0, buffer->thread_id);
+            out << line;
+        }
+    }
+    out << "\n]}\n";
+
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One begin ('B') or end ('E') event of the Trace Event format
+ */
+struct TraceEvent {
+    const char*   name; // must outlive the tracer (string literals)
+    std::uint64_t timestamp_ns;
+    char          phase;
+};
+
+/**
+ * @brief Records begin/end events into per-thread buffers and writes them as Chrome Trace Event JSON, which can be
+ * opened in chrome://tracing or Perfetto.
+ *
+ * Each thread appends to its own chain of fixed-size chunks and publishes the new event count with a release store, so
+ * recording never takes a lock; Flush() reads every buffer up to its published count. When tracing is off the only cost
+ * of a TRACE_SCOPE is a relaxed load of Tracer::enabled and one (well predicted) branch.
+ */
+class Tracer {
+    Tracer();
+
+public:
+    /// Checked by every trace site, set by Start()/Stop().
+    static inline std::atomic<bool> enabled{false};
+
+    static Tracer& GetInstance();
+
+    void Start();
+    void Stop();
+    bool IsRecording() const { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Write every event recorded since the last Start() as Trace Event JSON. Safe to call while recording.
+     * @param path Output file (usually *.json)
+     * @return true on success
+     */
+    bool Flush(const std::filesystem::path& path);
+
+    /**
+     * @brief Name the calling thread in the trace (shown as the track title)
+     */
+    void SetThreadName(const std::string& name);
+
+    static void Begin(const char* name) { GetInstance().Record(name, 'B'); }
+    static void End(const char* name) { GetInstance().Record(name, 'E'); }
+
+    /// Number of events dropped because a thread hit MAX_EVENTS_PER_THREAD.
+    std::uint64_t DroppedEvents() const;
+
+private:
+    static constexpr std::size_t CHUNK_EVENTS          = 4096;
+    static constexpr std::size_t MAX_EVENTS_PER_THREAD = 4u << 20;
+
+    struct Chunk {
+        TraceEvent          events[CHUNK_EVENTS];
+        std::atomic<Chunk*> next{nullptr};
+    };
+
+    struct ThreadBuffer {
+        ~ThreadBuffer();
+
+        std::uint32_t thread_id = 0;
+        std::string   thread_name;
+
+        Chunk*      head       = nullptr;
+        Chunk*      tail       = nullptr; // owner thread only
+        std::size_t tail_count = 0;       // owner thread only
+
+        // published is reset by the owner thread when it first records in a new session, before it updates session
+        std::atomic<std::size_t>   published{0};
+        std::atomic<std::uint32_t> session{0};
+        std::atomic<std::uint64_t> dropped{0};
+    };
+
+    void          Record(const char* name, char phase);
+    ThreadBuffer* LocalBuffer();
+
+    std::chrono::steady_clock::time_point epoch;
+    std::atomic<std::uint32_t>            session{0};
+
+    mutable std::mutex                         registry_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+/**
+ * @brief RAII begin/end pair. The enabled check is made once on entry and the result reused on exit, so a scope that
+ * starts while tracing is on always gets its end event.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* scope_name) {
+        if (Tracer::enabled.load(std::memory_order_relaxed)) [[unlikely]] {
+            name = scope_name;
+            Tracer::Begin(name);
+        }
+    }
+    ~TraceScope() {
+        if (name) [[unlikely]] Tracer::End(name);
+    }
+
+    TraceScope(const TraceScope&)            = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name = nullptr;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b)       TRACE_CONCAT_INNER(a, b)
+
+// trace the rest of the enclosing scope under the given (string literal) name
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
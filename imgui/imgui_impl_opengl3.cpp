@@ -214,6 +214,12 @@
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
 #endif
 
+// Desktop GL 4.4+ (or GL 3.2+ with ARB_buffer_storage) can keep vertex/index buffers persistently mapped, synchronized with fences.
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3) && defined(GL_MAP_PERSISTENT_BIT)
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+#define IMGUI_IMPL_OPENGL_RING_SEGMENTS     3   // Frames in flight: a segment is only rewritten once the GPU is done with it
+#endif
+
 // Desktop GL 3.3+ and GL ES 3.0+ have glBindSampler()
 #if !defined(IMGUI_IMPL_OPENGL_ES2) && (defined(IMGUI_IMPL_OPENGL_ES3) || defined(GL_VERSION_3_3))
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_BIND_SAMPLER
@@ -251,6 +257,17 @@ struct ImGui_ImplOpenGL3_Data
     bool            HasClipOrigin;
     bool            UseBufferSubData;
     ImVector<char>  TempBuffer;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    bool            HasBufferStorage;
+    bool            UsePersistentBuffers;    // Set by ImGui_ImplOpenGL3_SetPersistentBuffers()
+    GLuint          RingVboHandle, RingElementsHandle;
+    ImDrawVert*     RingVtxData;             // Mapped for the lifetime of the ring buffers (nullptr when the ring isn't in use)
+    ImDrawIdx*      RingIdxData;
+    int             RingVtxCapacity;         // Vertices/indices per segment
+    int             RingIdxCapacity;
+    int             RingSegment;             // Segment the next RenderDrawData() call writes
+    GLsync          RingFences[IMGUI_IMPL_OPENGL_RING_SEGMENTS];
+#endif
 
     ImGui_ImplOpenGL3_Data() { memset((void*)this, 0, sizeof(*this)); }
 };
@@ -405,6 +422,9 @@ bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
     bd->HasPolygonMode = (!bd->GlProfileIsES2 && !bd->GlProfileIsES3);
 #endif
     bd->HasClipOrigin = (bd->GlVersion >= 450);
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    bd->HasBufferStorage = (bd->GlVersion >= 440);
+#endif
 #ifdef IMGUI_IMPL_OPENGL_HAS_EXTENSIONS
     GLint num_extensions = 0;
     glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
@@ -413,6 +433,10 @@ bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
         const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
         if (extension != nullptr && strcmp(extension, "GL_ARB_clip_control") == 0)
             bd->HasClipOrigin = true;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+        if (extension != nullptr && strcmp(extension, "GL_ARB_buffer_storage") == 0 && bd->GlVersion >= 320) // Also needs fences and glDrawElementsBaseVertex()
+            bd->HasBufferStorage = true;
+#endif
     }
 #endif
 
@@ -515,8 +539,18 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
 #endif
 
     // Bind vertex/index buffers and setup attributes for ImDrawVert
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle));
-    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle));
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    if (bd->RingVtxData != nullptr)
+    {
+        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, bd->RingVboHandle));
+        GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->RingElementsHandle));
+    }
+    else
+#endif
+    {
+        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle));
+        GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle));
+    }
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxPos));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxUV));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxColor));
@@ -525,6 +559,97 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
     GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)offsetof(ImDrawVert, col)));
 }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+static void ImGui_ImplOpenGL3_DestroyRingBuffers(ImGui_ImplOpenGL3_Data* bd)
+{
+    // Deleting the buffers unmaps them, and the driver keeps them alive until the GPU has finished reading them
+    for (GLsync& fence : bd->RingFences)
+        if (fence) { glDeleteSync(fence); fence = nullptr; }
+    if (bd->RingVboHandle)      { glDeleteBuffers(1, &bd->RingVboHandle); bd->RingVboHandle = 0; }
+    if (bd->RingElementsHandle) { glDeleteBuffers(1, &bd->RingElementsHandle); bd->RingElementsHandle = 0; }
+    bd->RingVtxData = nullptr;
+    bd->RingIdxData = nullptr;
+    bd->RingVtxCapacity = bd->RingIdxCapacity = 0;
+    bd->RingSegment = 0;
+}
+
+static bool ImGui_ImplOpenGL3_CreateRingBuffers(ImGui_ImplOpenGL3_Data* bd, int vtx_capacity, int idx_capacity)
+{
+    // Both buffers are created through GL_ARRAY_BUFFER: binding GL_ELEMENT_ARRAY_BUFFER here would modify the caller's VAO
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr vtx_size = (GLsizeiptr)vtx_capacity * IMGUI_IMPL_OPENGL_RING_SEGMENTS * (int)sizeof(ImDrawVert);
+    const GLsizeiptr idx_size = (GLsizeiptr)idx_capacity * IMGUI_IMPL_OPENGL_RING_SEGMENTS * (int)sizeof(ImDrawIdx);
+    glGenBuffers(1, &bd->RingVboHandle);
+    glBindBuffer(GL_ARRAY_BUFFER, bd->RingVboHandle);
+    glBufferStorage(GL_ARRAY_BUFFER, vtx_size, nullptr, flags);
+    bd->RingVtxData = (ImDrawVert*)glMapBufferRange(GL_ARRAY_BUFFER, 0, vtx_size, flags);
+    glGenBuffers(1, &bd->RingElementsHandle);
+    glBindBuffer(GL_ARRAY_BUFFER, bd->RingElementsHandle);
+    glBufferStorage(GL_ARRAY_BUFFER, idx_size, nullptr, flags);
+    bd->RingIdxData = (ImDrawIdx*)glMapBufferRange(GL_ARRAY_BUFFER, 0, idx_size, flags);
+    if (bd->RingVtxData == nullptr || bd->RingIdxData == nullptr)
+    {
+        ImGui_ImplOpenGL3_DestroyRingBuffers(bd);
+        return false;
+    }
+    bd->RingVtxCapacity = vtx_capacity;
+    bd->RingIdxCapacity = idx_capacity;
+    return true;
+}
+
+// Pick the ring segment for this frame's vertices and indices, growing the ring if they don't fit.
+// Returns false when the ring can't be used and the glBufferData() path should be taken.
+static bool ImGui_ImplOpenGL3_BeginRingSegment(ImGui_ImplOpenGL3_Data* bd, ImDrawData* draw_data)
+{
+    if (!bd->UsePersistentBuffers)
+        return false;
+    if (bd->RingVtxCapacity < draw_data->TotalVtxCount || bd->RingIdxCapacity < draw_data->TotalIdxCount)
+    {
+        ImGui_ImplOpenGL3_DestroyRingBuffers(bd);
+        const int vtx_wanted = draw_data->TotalVtxCount + draw_data->TotalVtxCount / 2; // Some headroom, so a growing UI doesn't reallocate every frame
+        const int idx_wanted = draw_data->TotalIdxCount + draw_data->TotalIdxCount / 2;
+        const int vtx_capacity = vtx_wanted > 16 * 1024 ? vtx_wanted : 16 * 1024;
+        const int idx_capacity = idx_wanted > 32 * 1024 ? idx_wanted : 32 * 1024;
+        if (!ImGui_ImplOpenGL3_CreateRingBuffers(bd, vtx_capacity, idx_capacity))
+        {
+            bd->UsePersistentBuffers = false;
+            return false;
+        }
+    }
+
+    // Wait until the GPU has consumed what was written to this segment IMGUI_IMPL_OPENGL_RING_SEGMENTS frames ago
+    GLsync& fence = bd->RingFences[bd->RingSegment];
+    if (fence)
+    {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    return true;
+}
+
+static void ImGui_ImplOpenGL3_EndRingSegment(ImGui_ImplOpenGL3_Data* bd)
+{
+    bd->RingFences[bd->RingSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    bd->RingSegment = (bd->RingSegment + 1) % IMGUI_IMPL_OPENGL_RING_SEGMENTS;
+}
+#endif
+
+bool    ImGui_ImplOpenGL3_SetPersistentBuffers(bool enable)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Context or backend not initialized! Did you call ImGui_ImplOpenGL3_Init()?");
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    bd->UsePersistentBuffers = enable && bd->HasBufferStorage;
+    if (!bd->UsePersistentBuffers)
+        ImGui_ImplOpenGL3_DestroyRingBuffers(bd);
+    return bd->UsePersistentBuffers;
+#else
+    IM_UNUSED(enable);
+    return false;
+#endif
+}
+
 // OpenGL3 Render function.
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly.
 // This is in order to be able to run within an OpenGL engine that doesn't do so.
@@ -592,6 +717,12 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     GLuint vertex_array_object = 0;
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
     GL_CALL(glGenVertexArrays(1, &vertex_array_object));
+#endif
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    // With persistent buffers, the draw lists are copied one after the other into this frame's segment of the ring
+    const bool use_ring = ImGui_ImplOpenGL3_BeginRingSegment(bd, draw_data);
+    int ring_vtx_offset = use_ring ? bd->RingSegment * bd->RingVtxCapacity : 0;
+    int ring_idx_offset = use_ring ? bd->RingSegment * bd->RingIdxCapacity : 0;
 #endif
     ImGui_ImplOpenGL3_SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
 
@@ -602,6 +733,9 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     // Render command lists
     for (const ImDrawList* draw_list : draw_data->CmdLists)
     {
+        int vtx_base = 0; // Where this draw list starts in the bound buffers
+        int idx_base = 0;
+        IM_UNUSED(vtx_base); IM_UNUSED(idx_base);
         // Upload vertex/index buffers
         // - OpenGL drivers are in a very sorry state nowadays....
         //   During 2021 we attempted to switch from glBufferData() to orphaning+glBufferSubData() following reports
@@ -612,6 +746,18 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
         // - See https://github.com/ocornut/imgui/issues/4468 and please report any corruption issues.
         const GLsizeiptr vtx_buffer_size = (GLsizeiptr)draw_list->VtxBuffer.Size * (int)sizeof(ImDrawVert);
         const GLsizeiptr idx_buffer_size = (GLsizeiptr)draw_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+        if (use_ring)
+        {
+            memcpy(bd->RingVtxData + ring_vtx_offset, draw_list->VtxBuffer.Data, (size_t)vtx_buffer_size);
+            memcpy(bd->RingIdxData + ring_idx_offset, draw_list->IdxBuffer.Data, (size_t)idx_buffer_size);
+            vtx_base = ring_vtx_offset;
+            idx_base = ring_idx_offset;
+            ring_vtx_offset += draw_list->VtxBuffer.Size;
+            ring_idx_offset += draw_list->IdxBuffer.Size;
+        }
+        else
+#endif
         if (bd->UseBufferSubData)
         {
             if (bd->VertexBufferSize < vtx_buffer_size)
@@ -658,9 +804,16 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 
                 // Bind texture, Draw
                 GL_CALL(glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->GetTexID()));
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+                // Pass the vertex range along: without it the driver may scan the indices to find it, which for a
+                // persistently mapped buffer means waiting for the GPU (and defeats the point)
+                if (use_ring)
+                    GL_CALL(glDrawRangeElementsBaseVertex(GL_TRIANGLES, 0, (GLuint)(draw_list->VtxBuffer.Size - 1 - (int)pcmd->VtxOffset), (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)((idx_base + pcmd->IdxOffset) * sizeof(ImDrawIdx)), (GLint)(vtx_base + pcmd->VtxOffset)));
+                else
+#endif
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
                 if (bd->GlVersion >= 320)
-                    GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset));
+                    GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)((idx_base + pcmd->IdxOffset) * sizeof(ImDrawIdx)), (GLint)(vtx_base + pcmd->VtxOffset)));
                 else
 #endif
                 GL_CALL(glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx))));
@@ -668,6 +821,11 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
         }
     }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    if (use_ring)
+        ImGui_ImplOpenGL3_EndRingSegment(bd);
+#endif
+
     // Destroy the temporary VAO
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
     GL_CALL(glDeleteVertexArrays(1, &vertex_array_object));
@@ -1040,6 +1198,9 @@ void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
     ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
     if (bd->VboHandle)      { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
     if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_STORAGE
+    ImGui_ImplOpenGL3_DestroyRingBuffers(bd);
+#endif
     if (bd->ShaderHandle)   { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; }
 
     // Destroy all textures
@@ -44,6 +44,11 @@ IMGUI_IMPL_API void     ImGui_ImplOpenGL3_DestroyDeviceObjects();
 // (Advanced) Use e.g. if you need to precisely control the timing of texture updates (e.g. for staged rendering), by setting ImDrawData::Textures = NULL to handle this manually.
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_UpdateTexture(ImTextureData* tex);
 
+// (Optional) Stream vertices/indices through triple-buffered, persistently mapped ring buffers synchronized with fences, instead of
+// re-specifying the buffers with glBufferData() for every draw list. Needs desktop GL 4.4 or ARB_buffer_storage: returns false and keeps
+// the glBufferData() path otherwise.
+IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_SetPersistentBuffers(bool enable);
+
 // Configuration flags to add in your imconfig file:
 //#define IMGUI_IMPL_OPENGL_ES2     // Enable ES 2 (Auto-detected on Emscripten)
 //#define IMGUI_IMPL_OPENGL_ES3     // Enable ES 3 (Auto-detected on iOS/Android)
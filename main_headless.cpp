@@ -0,0 +1,551 @@
+// Headless frontend: runs the game's frames with a null renderer, for CPU frame benchmarks on machines without a GPU.
+//
+// The full imgui frame (ClassGame::RenderGame, Game::drawFrame, every window) is built exactly as in the real frontends,
+// then the ImDrawData is measured and thrown away. Mouse input is synthesised: the pointer wanders over the game window
+// and clicks every few frames, and finished games are reset so the benchmark keeps playing.
+//
+// Built with DEMO_HEADLESS_GL (the headless_gl target, Linux) the frames are rendered for real by imgui_impl_opengl3 into
+// an offscreen framebuffer of a surfaceless EGL context, which runs on Mesa's llvmpipe without a GPU. --compare-batch then
+// renders every frame a second time without the instanced SpriteBatch and fails if the game window's pixels differ.
+// --persistent-buffers streams the vertices through the backend's persistently mapped ring buffers instead of
+// glBufferData(). The frame time includes waiting for the rasterizer (glFinish, in place
+// of a swap); the render column is the time spent in ImGui_ImplOpenGL3_RenderDrawData.
+//
+// --soak-resets N skips the frames: it resets the game N times, playing each game out with random moves (and the odd
+// undo) straight through the Game API, and fails if the resident memory grows after the first 1% of the games.
+//
+//   headless [--frames N] [--size WxH] [--click-every N] [--no-input] [--seed N] [--csv file] [--profile file]
+//            [--soak-resets N] [--compare-batch] [--persistent-buffers]
+
+#include "imgui/imgui.h"
+#include "imgui/imgui_internal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Application.h"
+#include "classes/Game.h"
+#include "classes/Logger.hpp"
+#include "classes/Profiler.hpp"
+#include "classes/SpriteBatch.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#ifdef DEMO_HEADLESS_GL
+#include <glad/gl.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "imgui/imgui_impl_opengl3.h"
+#endif
+
+struct FrameStats
+{
+    double cpu_ms = 0.0;
+    double render_ms = 0.0;
+    int    draw_lists = 0;
+    int    draw_calls = 0;
+    int    callbacks = 0;
+    int    vertices = 0;
+    int    indices = 0;
+};
+
+struct Options
+{
+    int         frames = 1000;
+    float       width = 1280.0f;
+    float       height = 720.0f;
+    int         click_every = 10;
+    bool        input = true;
+    unsigned    seed = 1;
+    const char* csv_path = nullptr;
+    const char* profile_path = nullptr;
+    int         soak_resets = 0;
+    bool        compare_batch = false;
+    bool        persistent_buffers = false;
+};
+
+static bool ParseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--no-input") == 0)
+            options.input = false;
+        else if (strcmp(arg, "--frames") == 0 && value)
+            options.frames = atoi(argv[++i]);
+        else if (strcmp(arg, "--size") == 0 && value && sscanf(value, "%fx%f", &options.width, &options.height) == 2)
+            i++;
+        else if (strcmp(arg, "--click-every") == 0 && value)
+            options.click_every = std::max(1, atoi(argv[++i]));
+        else if (strcmp(arg, "--seed") == 0 && value)
+            options.seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(arg, "--csv") == 0 && value)
+            options.csv_path = argv[++i];
+        else if (strcmp(arg, "--profile") == 0 && value)
+            options.profile_path = argv[++i];
+        else if (strcmp(arg, "--soak-resets") == 0 && value)
+            options.soak_resets = atoi(argv[++i]);
+#ifdef DEMO_HEADLESS_GL
+        else if (strcmp(arg, "--compare-batch") == 0)
+            options.compare_batch = true;
+        else if (strcmp(arg, "--persistent-buffers") == 0)
+            options.persistent_buffers = true;
+#endif
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames N] [--size WxH] [--click-every N] [--no-input] [--seed N] [--csv file] [--profile file]"
+                            " [--soak-resets N]"
+#ifdef DEMO_HEADLESS_GL
+                            " [--compare-batch] [--persistent-buffers]"
+#endif
+                            "\n", argv[0]);
+            return false;
+        }
+    }
+    return options.frames > 0 && options.width > 0.0f && options.height > 0.0f;
+}
+
+#ifdef DEMO_HEADLESS_GL
+
+// The offscreen OpenGL renderer: a surfaceless EGL context (no window system needed) drawing into a framebuffer object
+struct GLRenderer
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    GLuint     framebuffer = 0;
+    GLuint     color = 0;
+    int        width = 0;
+    int        height = 0;
+};
+static GLRenderer gl_renderer;
+
+static bool GLRenderer_Init(int width, int height, bool persistent_buffers)
+{
+    auto get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    gl_renderer.display = get_platform_display ? get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                                               : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (gl_renderer.display == EGL_NO_DISPLAY || !eglInitialize(gl_renderer.display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_API))
+    {
+        fprintf(stderr, "EGL initialization failed (0x%x)\n", eglGetError());
+        return false;
+    }
+    const EGLint context_attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE,
+    };
+    gl_renderer.context = eglCreateContext(gl_renderer.display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, context_attributes);
+    if (gl_renderer.context == EGL_NO_CONTEXT || !eglMakeCurrent(gl_renderer.display, EGL_NO_SURFACE, EGL_NO_SURFACE, gl_renderer.context))
+    {
+        fprintf(stderr, "could not create an OpenGL 3.3 context (0x%x)\n", eglGetError());
+        return false;
+    }
+    if (!gladLoadGL((GLADloadfunc)eglGetProcAddress))
+    {
+        fprintf(stderr, "could not load OpenGL functions\n");
+        return false;
+    }
+
+    gl_renderer.width = width;
+    gl_renderer.height = height;
+    glGenRenderbuffers(1, &gl_renderer.color);
+    glBindRenderbuffer(GL_RENDERBUFFER, gl_renderer.color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenFramebuffers(1, &gl_renderer.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, gl_renderer.framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, gl_renderer.color);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        fprintf(stderr, "offscreen framebuffer is incomplete\n");
+        return false;
+    }
+    printf("renderer:    %s, OpenGL %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+
+    const char* glsl_version = "#version 150";
+    ImGui_ImplOpenGL3_Init(glsl_version);
+    if (persistent_buffers && !ImGui_ImplOpenGL3_SetPersistentBuffers(true))
+        fprintf(stderr, "persistent buffers are not supported, using glBufferData()\n");
+    if (!SpriteBatch::InitRenderer(glsl_version))
+        fprintf(stderr, "instanced sprite batches are not supported\n");
+    return true;
+}
+
+static void GLRenderer_Render(ImDrawData* draw_data)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, gl_renderer.framebuffer);
+    glViewport(0, 0, gl_renderer.width, gl_renderer.height);
+    glClearColor(0.45f, 0.55f, 0.60f, 1.00f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    ImGui_ImplOpenGL3_RenderDrawData(draw_data);
+}
+
+// RGBA pixels of a rectangle of the framebuffer, rows top to bottom
+static std::vector<unsigned char> GLRenderer_ReadPixels(int x, int y, int width, int height)
+{
+    std::vector<unsigned char> pixels((size_t)width * height * 4);
+    glBindFramebuffer(GL_FRAMEBUFFER, gl_renderer.framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(x, gl_renderer.height - y - height, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+static void GLRenderer_Shutdown()
+{
+    SpriteBatch::ShutdownRenderer();
+    ImGui_ImplOpenGL3_Shutdown();
+    glDeleteFramebuffers(1, &gl_renderer.framebuffer);
+    glDeleteRenderbuffers(1, &gl_renderer.color);
+    eglMakeCurrent(gl_renderer.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(gl_renderer.display, gl_renderer.context);
+    eglTerminate(gl_renderer.display);
+}
+
+struct BatchComparison
+{
+    int frames = 0;
+    int skipped_frames = 0;
+    int differing_frames = 0;
+    int max_difference = 0;
+};
+
+// Render the current game state as an instanced batch, through the draw list, and as a batch again, and compare the game
+// window. The game can move on between passes (the AI answers a frame after the player), so frames where the two batch
+// passes disagree are skipped. Only the game window's own draw list is rendered, so whatever shows through it from other
+// windows (like the settings checkbox this toggles) can't differ between the passes.
+static void CompareBatchFrame(BatchComparison& comparison)
+{
+    ImGuiWindow* window = ImGui::FindWindowByName("GameWindow");
+    if (window == nullptr || !SpriteBatch::Enabled())
+        return;
+    const int x0 = std::max(0, (int)window->InnerRect.Min.x), y0 = std::max(0, (int)window->InnerRect.Min.y);
+    const int x1 = std::min(gl_renderer.width, (int)window->InnerRect.Max.x), y1 = std::min(gl_renderer.height, (int)window->InnerRect.Max.y);
+    if (x1 <= x0 || y1 <= y0)
+        return;
+
+    std::vector<unsigned char> images[3];
+    for (int pass = 0; pass < 3; pass++)
+    {
+        SpriteBatch::SetEnabled(pass != 1);
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui::NewFrame();
+        ClassGame::RenderGame();
+        ImGui::Render();
+        ImDrawData game_window = *ImGui::GetDrawData();
+        game_window.CmdLists.clear();
+        game_window.CmdListsCount = 0;
+        game_window.TotalVtxCount = game_window.TotalIdxCount = 0;
+        game_window.AddDrawList(window->DrawList);
+        GLRenderer_Render(&game_window);
+        images[pass] = GLRenderer_ReadPixels(x0, y0, x1 - x0, y1 - y0);
+    }
+    SpriteBatch::SetEnabled(true);
+    if (images[0] != images[2])
+    {
+        comparison.skipped_frames++;
+        return;
+    }
+
+    int difference = 0;
+    for (size_t i = 0; i < images[0].size(); i++)
+        difference = std::max(difference, std::abs((int)images[0][i] - (int)images[1][i]));
+    comparison.frames++;
+    comparison.max_difference = std::max(comparison.max_difference, difference);
+    if (difference > 0)
+        comparison.differing_frames++;
+}
+
+#else
+
+
+// The null renderer: accept every texture request without uploading anything
+static void NullRenderer_UpdateTextures(ImDrawData* draw_data)
+{
+    // well away from the ids the headless GpuTexture hands out, so font and game textures never look alike
+    static ImTextureID next_texture = (ImTextureID)1 << 40;
+    if (draw_data->Textures == nullptr)
+        return;
+    for (ImTextureData* tex : *draw_data->Textures)
+    {
+        if (tex->Status == ImTextureStatus_WantCreate)
+        {
+            tex->SetTexID(next_texture++);
+            tex->SetStatus(ImTextureStatus_OK);
+        }
+        else if (tex->Status == ImTextureStatus_WantUpdates)
+        {
+            tex->SetStatus(ImTextureStatus_OK);
+        }
+        else if (tex->Status == ImTextureStatus_WantDestroy && tex->UnusedFrames > 0)
+        {
+            tex->SetTexID(ImTextureID_Invalid);
+            tex->SetStatus(ImTextureStatus_Destroyed);
+        }
+    }
+}
+
+#endif
+
+static FrameStats MeasureDrawData(const ImDrawData* draw_data)
+{
+    FrameStats stats;
+    stats.draw_lists = draw_data->CmdListsCount;
+    stats.vertices = draw_data->TotalVtxCount;
+    stats.indices = draw_data->TotalIdxCount;
+    for (const ImDrawList* draw_list : draw_data->CmdLists)
+        for (const ImDrawCmd& cmd : draw_list->CmdBuffer)
+        {
+            if (cmd.UserCallback != nullptr)
+                stats.callbacks++;
+            else if (cmd.ElemCount > 0)
+                stats.draw_calls++;
+        }
+    return stats;
+}
+
+static double Percentile(std::vector<double> values, double fraction)
+{
+    std::sort(values.begin(), values.end());
+    const size_t index = std::min(values.size() - 1, (size_t)(fraction * (double)(values.size() - 1) + 0.5));
+    return values[index];
+}
+
+static int Shutdown(int result)
+{
+    ClassGame::GameShutDown();
+#ifdef DEMO_HEADLESS_GL
+    GLRenderer_Shutdown();
+#else
+    for (ImTextureData* tex : ImGui::GetPlatformIO().Textures)
+        if (tex->RefCount == 1)
+        {
+            tex->SetTexID(ImTextureID_Invalid);
+            tex->SetStatus(ImTextureStatus_Destroyed);
+        }
+#endif
+    ImGui::DestroyContext();
+    return result;
+}
+
+// resident set size in bytes, or 0 where it can't be read
+static size_t ResidentBytes()
+{
+#ifdef __linux__
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    unsigned long size = 0, resident = 0;
+    const int read = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+    return read == 2 ? (size_t)resident * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+// every game reuses the last one's players, bits and move storage, so once those have grown to a full game nothing
+// more should be allocated for good
+static int RunSoak(int resets, unsigned seed)
+{
+    // every move and result would be logged, flooding stdout and output.log and filling the log window's entries
+    // while the memory is watched
+    Logger::GetInstance().SetMinimumLevel(LogLevel::Warn);
+
+    const size_t allowed_growth = 1024 * 1024;
+    const int warmup = std::max(1, resets / 100);
+    const int report_every = std::max(1, resets / 10);
+
+    std::mt19937 random(seed);
+    size_t baseline = 0, peak = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < resets; i++)
+    {
+        ClassGame::ResetGame();
+        Game* game = ClassGame::CurrentGame();
+        std::uniform_int_distribution<int> column(0, game->_gameOptions.rowX - 1);
+        std::uniform_int_distribution<int> row(0, game->_gameOptions.rowY - 1);
+        while (!ClassGame::IsGameOver())
+        {
+            BitHolder& holder = game->getHolderAt(column(random), row(random));
+            if (!game->actionForEmptyHolder(&holder))
+                continue;
+            game->endTurn(&holder);
+            // the next move then replaces the undone one, dropping the redo history
+            if (!ClassGame::IsGameOver() && random() % 4 == 0)
+                game->undoTurn();
+        }
+
+        const size_t resident = ResidentBytes();
+        if (i + 1 == warmup)
+            baseline = resident;
+        peak = std::max(peak, resident);
+        if ((i + 1) % report_every == 0)
+            printf("soak: %d resets, rss %.2f MB\n", i + 1, (double)resident / (1024.0 * 1024.0));
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("soak: %d resets in %.1f s, rss %.2f MB after %d, peak %.2f MB\n", resets, seconds,
+           (double)baseline / (1024.0 * 1024.0), warmup, (double)peak / (1024.0 * 1024.0));
+    if (baseline == 0)
+    {
+        printf("soak: resident memory can't be read on this platform, not checked\n");
+        return 0;
+    }
+    if (peak > baseline + allowed_growth)
+    {
+        printf("soak: FAILED, memory grew by %.2f MB\n", (double)(peak - baseline) / (1024.0 * 1024.0));
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+        return 2;
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+    io.IniFilename = nullptr; // start from the same layout every run
+    io.BackendPlatformName = "headless";
+    io.DisplaySize = ImVec2(options.width, options.height);
+    ImGui::StyleColorsDark();
+#ifdef DEMO_HEADLESS_GL
+    if (!GLRenderer_Init((int)options.width, (int)options.height, options.persistent_buffers))
+        return 1;
+    BatchComparison comparison;
+#else
+    io.BackendRendererName = "null";
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures | ImGuiBackendFlags_RendererHasVtxOffset;
+#endif
+
+    ClassGame::GameStartUp();
+
+    if (options.soak_resets > 0)
+        return Shutdown(RunSoak(options.soak_resets, options.seed));
+
+    FILE* csv = options.csv_path ? fopen(options.csv_path, "w") : nullptr;
+    if (csv)
+        fprintf(csv, "frame,cpu_ms,render_ms,draw_lists,draw_calls,callbacks,vertices,indices\n");
+
+    std::mt19937 random(options.seed);
+    std::vector<FrameStats> frames;
+    frames.reserve((size_t)options.frames);
+    int games = 0;
+
+    for (int frame = 0; frame < options.frames; frame++)
+    {
+        // fixed time step, so runs are comparable whatever the machine
+        io.DeltaTime = 1.0f / 60.0f;
+
+        if (options.input)
+        {
+            // the window list is only complete after the first frame
+            ImGuiWindow* window = frame > 0 ? ImGui::FindWindowByName("GameWindow") : nullptr;
+            if (window != nullptr)
+            {
+                std::uniform_real_distribution<float> x(window->Pos.x, window->Pos.x + window->Size.x);
+                std::uniform_real_distribution<float> y(window->Pos.y, window->Pos.y + window->Size.y);
+                const bool click = frame % options.click_every == 0;
+                io.AddMousePosEvent(x(random), y(random));
+                if (click)
+                    io.AddMouseButtonEvent(0, true);
+                else if (frame % options.click_every == 1)
+                    io.AddMouseButtonEvent(0, false);
+            }
+            if (ClassGame::IsGameOver())
+            {
+                ClassGame::ResetGame();
+                games++;
+            }
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+#ifdef DEMO_HEADLESS_GL
+        ImGui_ImplOpenGL3_NewFrame();
+#endif
+        ImGui::NewFrame();
+        ClassGame::RenderGame();
+        ImGui::Render();
+        ImDrawData* draw_data = ImGui::GetDrawData();
+        FrameStats stats = MeasureDrawData(draw_data);
+#ifdef DEMO_HEADLESS_GL
+        const auto render_start = std::chrono::steady_clock::now();
+        GLRenderer_Render(draw_data);
+        stats.render_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - render_start).count();
+        // wait for the rasterizer like a swap would, so the frame time includes it whichever way the driver schedules it
+        glFinish();
+        const auto end = std::chrono::steady_clock::now();
+#else
+        NullRenderer_UpdateTextures(draw_data);
+        const auto end = std::chrono::steady_clock::now();
+#endif
+        stats.cpu_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        frames.push_back(stats);
+#ifdef DEMO_HEADLESS_GL
+        if (options.compare_batch)
+            CompareBatchFrame(comparison);
+#endif
+
+        if (csv)
+            fprintf(csv, "%d,%.4f,%.4f,%d,%d,%d,%d,%d\n", frame, stats.cpu_ms, stats.render_ms, stats.draw_lists, stats.draw_calls, stats.callbacks, stats.vertices, stats.indices);
+    }
+
+    if (csv)
+        fclose(csv);
+    if (options.profile_path && !Profiler::GetInstance().DumpJSON(options.profile_path))
+        fprintf(stderr, "could not write %s\n", options.profile_path);
+
+    std::vector<double> cpu_ms, render_ms;
+    double draw_calls = 0.0, vertices = 0.0, indices = 0.0;
+    int max_draw_calls = 0, max_vertices = 0;
+    for (const FrameStats& stats : frames)
+    {
+        cpu_ms.push_back(stats.cpu_ms);
+        render_ms.push_back(stats.render_ms);
+        draw_calls += stats.draw_calls;
+        vertices += stats.vertices;
+        indices += stats.indices;
+        max_draw_calls = std::max(max_draw_calls, stats.draw_calls);
+        max_vertices = std::max(max_vertices, stats.vertices);
+    }
+    const double count = (double)frames.size();
+    double total_ms = 0.0;
+    for (double ms : cpu_ms)
+        total_ms += ms;
+
+    printf("frames:      %d (%dx%d, %d games finished)\n", options.frames, (int)options.width, (int)options.height, games);
+    printf("cpu ms:      avg %.4f  p50 %.4f  p99 %.4f  max %.4f\n", total_ms / count, Percentile(cpu_ms, 0.5), Percentile(cpu_ms, 0.99), Percentile(cpu_ms, 1.0));
+#ifdef DEMO_HEADLESS_GL
+    double total_render_ms = 0.0;
+    for (double ms : render_ms)
+        total_render_ms += ms;
+    printf("render ms:   avg %.4f  p50 %.4f  p99 %.4f  max %.4f\n", total_render_ms / count, Percentile(render_ms, 0.5), Percentile(render_ms, 0.99), Percentile(render_ms, 1.0));
+#endif
+    printf("draw calls:  avg %.1f  max %d\n", draw_calls / count, max_draw_calls);
+    printf("vertices:    avg %.1f  max %d\n", vertices / count, max_vertices);
+    printf("indices:     avg %.1f\n", indices / count);
+
+    int result = 0;
+#ifdef DEMO_HEADLESS_GL
+    if (options.compare_batch)
+    {
+        printf("batch check: %d frames compared (%d skipped while the game moved), %d differ, max channel difference %d\n",
+               comparison.frames, comparison.skipped_frames, comparison.differing_frames, comparison.max_difference);
+        result = comparison.differing_frames > 0 ? 1 : 0;
+    }
+#endif
+    return Shutdown(result);
+}
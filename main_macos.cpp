@@ -18,6 +18,7 @@
 #include "imgui/imgui_impl_glfw.h"
 #include "imgui/imgui_impl_opengl3.h"
 #include <stdio.h>
+#include <stdlib.h>
 
 #ifndef DEMO_USE_GLAD_FOR_GL
 #define GL_SILENCE_DEPRECATION
@@ -28,6 +29,9 @@
 
 #include <GLFW/glfw3.h> // Will drag system OpenGL headers
 #include "Application.h"
+#include "classes/FrameScheduler.hpp"
+#include "classes/SpriteBatch.hpp"
+#include "classes/Tracer.hpp"
 
 // [Win32] Our example includes a copy of glfw3.lib pre-compiled with VS2010 to maximize ease of testing and compatibility with old VS compilers.
 // To link with VS2010-era libraries, VS2015+ requires linking with legacy_stdio_definitions.lib, which we do using this pragma.
@@ -113,6 +117,10 @@ int main(int, char**)
     // Setup Platform/Renderer backends
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
+    // opt in to the backend's persistently mapped vertex buffers (they need GL 4.4 or ARB_buffer_storage)
+    if (getenv("TICTACTOE_PERSISTENT_BUFFERS") != nullptr && !ImGui_ImplOpenGL3_SetPersistentBuffers(true))
+        fprintf(stderr, "Persistent vertex buffers are not supported, using glBufferData()\n");
+    SpriteBatch::InitRenderer(glsl_version);
 
     // Load Fonts
     // - If no fonts are loaded, dear imgui will use the default font. You can also load multiple fonts and use ImGui::PushFont()/PopFont() to select them.
@@ -136,6 +144,9 @@ int main(int, char**)
     bool show_another_window = false;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
     ClassGame::GameStartUp();
+
+    // lets worker threads (AI search, logging) wake the loop while it sleeps in power-saving mode
+    FrameScheduler::GetInstance().SetWakeFunction(glfwPostEmptyEvent);
     
     // Main loop
 #ifdef __EMSCRIPTEN__
@@ -152,6 +163,8 @@ int main(int, char**)
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+        // In power-saving mode we block here until there is input or something requests a frame.
+        FrameScheduler::GetInstance().WaitForEvents(glfwWaitEventsTimeout);
         glfwPollEvents();
 
         // Start the Dear ImGui frame
@@ -162,25 +175,33 @@ int main(int, char**)
         ClassGame::RenderGame();
 
         // Rendering
-        ImGui::Render();
+        {
+            TRACE_SCOPE("ImGui::Render");
+            ImGui::Render();
+        }
         int display_w, display_h;
         glfwGetFramebufferSize(window, &display_w, &display_h);
         glViewport(0, 0, display_w, display_h);
         glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
         glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            TRACE_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // Update and Render additional Platform Windows
         // (Platform functions may change the current OpenGL context, so we save/restore it to make it easier to paste this code elsewhere.
         //  For this specific demo app we could also call glfwMakeContextCurrent(window) directly)
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         {
+            TRACE_SCOPE("ImGui::RenderPlatformWindows");
             GLFWwindow* backup_current_context = glfwGetCurrentContext();
             ImGui::UpdatePlatformWindows();
             ImGui::RenderPlatformWindowsDefault();
             glfwMakeContextCurrent(backup_current_context);
         }
 
+        TRACE_SCOPE("glfwSwapBuffers");
         glfwSwapBuffers(window);
     }
 #ifdef __EMSCRIPTEN__
@@ -188,6 +209,8 @@ int main(int, char**)
 #endif
 
     // Cleanup
+    ClassGame::GameShutDown();
+    SpriteBatch::ShutdownRenderer();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -12,6 +12,7 @@
 #include <d3d11.h>
 #include <tchar.h>
 #include "Application.h"
+#include "classes/FrameScheduler.hpp"
 
 // Data
 ID3D11Device*                  g_pd3dDevice           = nullptr;
@@ -20,6 +21,7 @@ static IDXGISwapChain*         g_pSwapChain           = nullptr;
 static bool                    g_SwapChainOccluded    = false;
 static UINT                    g_ResizeWidth          = 0, g_ResizeHeight = 0;
 static ID3D11RenderTargetView* g_mainRenderTargetView = nullptr;
+static HWND                    g_hWnd                 = nullptr;
 
 // Forward declarations of helper functions
 bool           CreateDeviceD3D(HWND hWnd);
@@ -114,11 +116,19 @@ int main(int, char**) {
     // Our state
     ClassGame::GameStartUp();
 
+    // lets worker threads (AI search, logging) wake the loop while it sleeps in power-saving mode
+    g_hWnd = hwnd;
+    FrameScheduler::GetInstance().SetWakeFunction([]() { ::PostMessage(g_hWnd, WM_NULL, 0, 0); });
+
     // Main loop
     bool done = false;
     while (!done) {
         // Poll and handle messages (inputs, window resize, etc.)
         // See the WndProc() function below for our to dispatch events to the Win32 backend.
+        // In power-saving mode we block here until there is input or something requests a frame.
+        FrameScheduler::GetInstance().WaitForEvents([](double timeout) {
+            ::MsgWaitForMultipleObjects(0, nullptr, FALSE, static_cast<DWORD>(timeout * 1000.0), QS_ALLINPUT);
+        });
         MSG msg;
         while (::PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE)) {
             ::TranslateMessage(&msg);
@@ -172,6 +182,7 @@ int main(int, char**) {
     }
 
     // Cleanup
+    ClassGame::GameShutDown();
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
     ImGui::DestroyContext();
@@ -0,0 +1,110 @@
+//
+// archivestat: summarize a game archive written by the game (TICTACTOE_ARCHIVE=<file>)
+//
+//   archivestat <archive> [game number]
+//
+// Without a game number it prints result and game length counts and the most played first moves; with one it prints
+// that game's moves.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "classes/GameArchive.hpp"
+#include "classes/MoveLog.hpp"
+
+static void PrintGame(const GameRecordView& game) {
+    std::printf("game %u: %ux%u board, %zu players, %u moves, ", game.game_number, game.columns, game.rows,
+                game.players.size(), game.move_count);
+    if (game.winner < 0) std::printf("draw\n");
+    else std::printf("won by player %d\n", game.winner);
+
+    std::size_t offset = 0;
+    for (std::uint32_t i = 0; i < game.move_count && offset < game.moves.size(); i++) {
+        MoveLog::Move move;
+        offset += MoveLog::DecodeMove(game.moves.data() + offset, move);
+        const unsigned int player = game.players.empty() ? 0 : i % game.players.size();
+        if (move.to == MoveLog::NO_CELL) {
+            std::printf("  %3u  player %u passed\n", i + 1, player);
+        }
+        else if (move.from == MoveLog::NO_CELL) {
+            std::printf("  %3u  player %u placed at (%u, %u)\n", i + 1, player, move.to % game.columns,
+                        move.to / game.columns);
+        }
+        else {
+            std::printf("  %3u  player %u moved (%u, %u) to (%u, %u)\n", i + 1, player, move.from % game.columns,
+                        move.from / game.columns, move.to % game.columns, move.to / game.columns);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::fprintf(stderr, "usage: %s <archive> [game number]\n", argv[0]);
+        return 2;
+    }
+
+    const auto        start = std::chrono::steady_clock::now();
+    GameArchiveReader reader;
+    if (!reader.Open(argv[1])) {
+        std::fprintf(stderr, "archivestat: could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    GameRecordView game;
+    if (argc == 3) {
+        const std::size_t position = reader.Find(static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10)));
+        if (!reader.Read(position, game)) {
+            std::fprintf(stderr, "archivestat: no game %s in %s\n", argv[2], argv[1]);
+            return 1;
+        }
+        PrintGame(game);
+        return 0;
+    }
+
+    std::map<int, std::size_t>           results;
+    std::map<std::uint32_t, std::size_t> lengths;
+    std::map<std::uint32_t, std::size_t> openings;
+    std::size_t                          damaged = 0;
+    std::uint64_t                        moves   = 0;
+    for (std::size_t i = 0; i < reader.Count(); i++) {
+        if (!reader.Read(i, game)) {
+            damaged++;
+            continue;
+        }
+        results[game.winner]++;
+        lengths[game.move_count]++;
+        moves += game.move_count;
+        if (!game.moves.empty()) {
+            MoveLog::Move first;
+            MoveLog::DecodeMove(game.moves.data(), first);
+            openings[first.to]++;
+        }
+    }
+
+    const double      ms    = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const std::size_t games = reader.Count() - damaged;
+    std::printf("%zu games, %llu moves (%.2f ms)\n", games, static_cast<unsigned long long>(moves), ms);
+    if (damaged > 0) std::printf("%zu damaged records skipped\n", damaged);
+    for (const auto& [winner, count] : results) {
+        if (winner < 0) std::printf("  draws:           %zu\n", count);
+        else std::printf("  won by player %d: %zu\n", winner, count);
+    }
+    std::printf("game length:\n");
+    for (const auto& [length, count] : lengths) {
+        std::printf("  %3u moves: %zu\n", length, count);
+    }
+
+    std::vector<std::pair<std::size_t, std::uint32_t>> ranked;
+    for (const auto& [cell, count] : openings) ranked.emplace_back(count, cell);
+    std::sort(ranked.rbegin(), ranked.rend());
+    std::printf("most played first moves:\n");
+    for (std::size_t i = 0; i < ranked.size() && i < 5; i++) {
+        std::printf("  cell %u: %zu\n", ranked[i].second, ranked[i].first);
+    }
+    return 0;
+}
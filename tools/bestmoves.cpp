@@ -0,0 +1,165 @@
+//
+// bestmoves: perfect-play best moves for many positions at once, through TicTacToeAI::BestMoves()
+//
+//   bestmoves [--archive file] [--positions N] [--threads N]
+//
+// With --archive the positions are the boards before and after every move of every two-player 3x3 game in a game
+// archive (TICTACTOE_ARCHIVE=<file>), and it reports how often the AI's and the humans' moves were among the best ones.
+// Without it they are all the reachable positions where the game goes on, repeated up to --positions (a million by
+// default). Either way the batch is searched twice, first against the empty transposition table and then against the
+// one the first run filled, and both rates are printed.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "classes/GameArchive.hpp"
+#include "classes/MoveLog.hpp"
+#include "classes/ThreadPool.hpp"
+#include "classes/TicTacToeAI.hpp"
+
+namespace {
+    using TicTacToeAI::Move;
+    using TicTacToeAI::Position;
+
+    struct Options {
+        const char* archive   = nullptr;
+        std::size_t positions = 1000000;
+        std::size_t threads   = 0;
+    };
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg   = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (std::strcmp(arg, "--archive") == 0 && value) options.archive = argv[++i];
+            else if (std::strcmp(arg, "--positions") == 0 && value) options.positions = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(arg, "--threads") == 0 && value) options.threads = std::strtoull(argv[++i], nullptr, 10);
+            else {
+                std::fprintf(stderr, "usage: %s [--archive file] [--positions N] [--threads N]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // every position reachable from the empty board where the game isn't over yet
+    void AddReachable(Position& position, std::vector<bool>& seen, int code, std::vector<Position>& positions) {
+        if (seen[code]) return;
+        seen[code] = true;
+        if (TicTacToeAI::Winner(std::string(position.cells.begin(), position.cells.end())) != '0') return;
+        positions.push_back(position);
+
+        const char player = position.player;
+        position.player   = player == '1' ? '2' : '1';
+        for (int i = 0, power = 1; i < 9; i++, power *= 3) {
+            if (position.cells[i] != '0') continue;
+            position.cells[i] = player;
+            AddReachable(position, seen, code + (player - '0') * power, positions);
+            position.cells[i] = '0';
+        }
+        position.player = player;
+    }
+
+    // a played move: the positions before and after it in the batch, and whether the AI made it
+    struct PlayedMove {
+        std::size_t before;
+        bool        ai;
+    };
+
+    bool ReadArchive(const char* path, std::vector<Position>& positions, std::vector<PlayedMove>& played) {
+        GameArchiveReader reader;
+        if (!reader.Open(path)) return false;
+
+        GameRecordView game;
+        for (std::size_t i = 0; i < reader.Count(); i++) {
+            if (!reader.Read(i, game) || game.columns != 3 || game.rows != 3 || game.players.size() != 2 ||
+                game.start_board.size() != 9) {
+                continue;
+            }
+
+            Position position;
+            for (int cell = 0; cell < 9; cell++) {
+                position.cells[cell] = static_cast<char>('0' + std::min<std::uint8_t>(game.start_board[cell], 2));
+            }
+            position.player = '1';
+            positions.push_back(position);
+
+            std::size_t offset = 0;
+            for (std::uint32_t turn = 0; turn < game.move_count && offset < game.moves.size(); turn++) {
+                MoveLog::Move move;
+                offset += MoveLog::DecodeMove(game.moves.data() + offset, move);
+                if (move.from != MoveLog::NO_CELL || move.to >= 9 || position.cells[move.to] != '0') break;
+
+                played.push_back({positions.size() - 1, game.players[turn % 2] == GameArchive::PLAYER_AI});
+                position.cells[move.to] = position.player;
+                position.player         = position.player == '1' ? '2' : '1';
+                positions.push_back(position);
+            }
+        }
+        return true;
+    }
+
+    double SearchAll(const std::vector<Position>& positions, std::vector<Move>& moves, ThreadPool& pool) {
+        const auto start = std::chrono::steady_clock::now();
+        TicTacToeAI::BestMoves(positions, moves, &pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) return 2;
+
+    std::vector<Position>   positions;
+    std::vector<PlayedMove> played;
+    if (options.archive) {
+        if (!ReadArchive(options.archive, positions, played)) {
+            std::fprintf(stderr, "bestmoves: could not open %s\n", options.archive);
+            return 1;
+        }
+    }
+    else {
+        Position          empty;
+        std::vector<bool> seen(19683);
+        empty.cells.fill('0');
+        empty.player = '1';
+        AddReachable(empty, seen, 0, positions);
+        const std::size_t reachable = positions.size();
+        positions.reserve(std::max(options.positions, reachable));
+        for (std::size_t i = reachable; i < options.positions; i++) positions.push_back(positions[i % reachable]);
+    }
+
+    std::vector<Move> moves(positions.size());
+    ThreadPool        pool("BestMoves", options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                                                             : options.threads);
+    const double      cold = SearchAll(positions, moves, pool);
+    const double      warm = SearchAll(positions, moves, pool);
+
+    std::printf("%zu positions on %zu threads\n", positions.size(), pool.ThreadCount());
+    std::printf("  empty table:  %.2f ms, %.0f positions/s\n", cold * 1000.0, static_cast<double>(positions.size()) / cold);
+    std::printf("  filled table: %.2f ms, %.0f positions/s\n", warm * 1000.0, static_cast<double>(positions.size()) / warm);
+
+    if (options.archive) {
+        // a move was among the best if the position it left is worth as much to the mover as the one it started from
+        std::uint64_t counts[2] = {}, best[2] = {};
+        for (const PlayedMove& move : played) {
+            counts[move.ai]++;
+            if (-moves[move.before + 1].value == moves[move.before].value) best[move.ai]++;
+        }
+        const char* names[2] = {"human", "AI"};
+        for (int ai = 0; ai < 2; ai++) {
+            if (counts[ai] == 0) continue;
+            std::printf("%-6s %llu moves, %.1f%% among the best\n", names[ai], static_cast<unsigned long long>(counts[ai]),
+                        100.0 * static_cast<double>(best[ai]) / static_cast<double>(counts[ai]));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+//
+// texcache: build the texture atlas cache offline, so the game's first start doesn't have to decode any PNGs
+//
+//   texcache <resources directory> [output file]
+//
+// The output defaults to <resources directory>/atlas.cache, which is where the game looks for it.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "classes/AtlasCache.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "classes/stb_image.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::fprintf(stderr, "usage: %s <resources directory> [output file]\n", argv[0]);
+        return 2;
+    }
+
+    const std::filesystem::path directory = argv[1];
+    const std::filesystem::path output    = argc == 3 ? std::filesystem::path(argv[2]) : directory / AtlasCache::FILE_NAME;
+
+    const auto  start = std::chrono::steady_clock::now();
+    PackedAtlas atlas;
+    std::string error;
+    if (!AtlasCache::Pack(directory, atlas, error)) {
+        std::fprintf(stderr, "texcache: %s\n", error.c_str());
+        return 1;
+    }
+    if (!AtlasCache::Write(output, atlas, AtlasCache::Fingerprint(directory))) {
+        std::fprintf(stderr, "texcache: could not write %s\n", output.string().c_str());
+        return 1;
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("texcache: %zu images packed into %ux%u, written to %s (%.2f ms)\n", atlas.regions.size(), atlas.width,
+                atlas.height, output.string().c_str(), ms);
+    return 0;
+}
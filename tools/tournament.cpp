@@ -0,0 +1,250 @@
+//
+// tournament: AI configurations playing each other, many headless games at once on a work-stealing thread pool
+//
+//   tournament [--games N] [--threads N] [--seed N] [--resources dir] [--ai name:depth:blunder]...
+//
+// Every AI plays every other one N games moving first and N games moving second (depth -1 searches the whole game,
+// blunder is the chance of a random move instead). Without --ai the field is random, greedy (takes wins and blocks),
+// sloppy (perfect with 20% random moves) and perfect. The results are the win/draw/loss rates, Elo ratings fitted to
+// all the games and the number of games played per second.
+//
+// Each task plays a batch of games of one pairing on its own TicTacToe instance with no listeners, so games share
+// nothing but the read-only texture atlas; the atlas has to be built (from --resources, resources/ by default) for the
+// pieces' sprites not to go through the render thread's texture loader.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "classes/Logger.hpp"
+#include "classes/TextureAtlas.hpp"
+#include "classes/ThreadPool.hpp"
+#include "classes/TicTacToe.h"
+#include "classes/TicTacToeAI.hpp"
+
+namespace {
+    // games per task: enough to amortize setting up a game, few enough that stealing can even the load out
+    constexpr int GAMES_PER_TASK = 200;
+
+    struct Options {
+        int                   games     = 10000;
+        std::size_t           threads   = 0;
+        std::uint32_t         seed      = 1;
+        const char*           resources = "resources";
+        std::vector<AIConfig> players;
+    };
+
+    // the results of one AI moving first against another
+    struct PairingResult {
+        std::uint64_t first_wins  = 0;
+        std::uint64_t draws       = 0;
+        std::uint64_t second_wins = 0;
+    };
+
+    bool ParseAI(const char* text, AIConfig& config) {
+        char   name[64];
+        int    depth   = -1;
+        double blunder = 0.0;
+        if (std::sscanf(text, "%63[^:]:%d:%lf", name, &depth, &blunder) < 1) return false;
+        config.name    = name;
+        config.depth   = depth;
+        config.blunder = std::clamp(blunder, 0.0, 1.0);
+        return true;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg   = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            AIConfig    config;
+            if (std::strcmp(arg, "--games") == 0 && value) options.games = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(arg, "--threads") == 0 && value) options.threads = std::strtoul(argv[++i], nullptr, 10);
+            else if (std::strcmp(arg, "--seed") == 0 && value) options.seed = std::strtoul(argv[++i], nullptr, 10);
+            else if (std::strcmp(arg, "--resources") == 0 && value) options.resources = argv[++i];
+            else if (std::strcmp(arg, "--ai") == 0 && value && ParseAI(value, config)) {
+                options.players.push_back(config);
+                i++;
+            }
+            else {
+                std::fprintf(stderr,
+                             "usage: %s [--games N] [--threads N] [--seed N] [--resources dir] "
+                             "[--ai name:depth:blunder]...\n",
+                             argv[0]);
+                return false;
+            }
+        }
+        if (options.players.empty()) {
+            options.players = {{"random", 0, 1.0}, {"greedy", 1, 0.0}, {"sloppy", -1, 0.2}, {"perfect", -1, 0.0}};
+        }
+        return options.players.size() >= 2;
+    }
+
+    void PlayGames(const AIConfig& first, const AIConfig& second, const int games, const std::uint32_t seed,
+                   PairingResult& result) {
+        TicTacToe game;
+        game.setAIEnabled(false); // both sides are played from here
+        game.setUpBoard();
+        std::mt19937 random(seed);
+
+        for (int i = 0; i < games; i++) {
+            while (!game.gameOver()) {
+                const int       player = game.getCurrentPlayer()->playerNumber();
+                const AIConfig& config = player == 0 ? first : second;
+                const int square = TicTacToeAI::ChooseMove(game.stateString(), static_cast<char>('1' + player), config,
+                                                           random);
+                BitHolder& holder = game.getHolderAt(square % 3, square / 3);
+                game.actionForEmptyHolder(&holder);
+                game.endTurn(&holder); // works out the result once, for the loop and the tally below
+            }
+            if (game.isDraw()) result.draws++;
+            else (game.winner()->playerNumber() == 0 ? result.first_wins : result.second_wins)++;
+            game.stopGame();
+            game.setUpBoard();
+        }
+    }
+
+    // Bradley-Terry ratings fitted by minorization-maximization (Hunter 2004), a draw counting as half a win each way.
+    // every pairing gets one extra virtual draw, so a player that never drops a point still gets a finite rating
+    std::vector<double> FitElo(const std::vector<PairingResult>& results, const std::size_t players) {
+        std::vector<double> score(players, 0.0);
+        std::vector<double> games(players * players, 0.0); // between i and j, either moving first
+        for (std::size_t a = 0; a < players; a++) {
+            for (std::size_t b = 0; b < players; b++) {
+                if (a == b) continue;
+                const PairingResult& r     = results[a * players + b];
+                const double         total = static_cast<double>(r.first_wins + r.draws + r.second_wins) + 1.0;
+                score[a] += static_cast<double>(r.first_wins) + 0.5 * static_cast<double>(r.draws) + 0.5;
+                score[b] += static_cast<double>(r.second_wins) + 0.5 * static_cast<double>(r.draws) + 0.5;
+                games[a * players + b] += total;
+                games[b * players + a] += total;
+            }
+        }
+
+        std::vector<double> strength(players, 1.0);
+        for (int iteration = 0; iteration < 1000; iteration++) {
+            std::vector<double> next(players);
+            for (std::size_t i = 0; i < players; i++) {
+                double denominator = 0.0;
+                for (std::size_t j = 0; j < players; j++) {
+                    if (i != j) denominator += games[i * players + j] / (strength[i] + strength[j]);
+                }
+                next[i] = score[i] / denominator;
+            }
+            strength.swap(next);
+        }
+
+        // centred on 1500
+        std::vector<double> elo(players);
+        double              mean = 0.0;
+        for (std::size_t i = 0; i < players; i++) {
+            elo[i] = 400.0 * std::log10(strength[i]);
+            mean += elo[i] / static_cast<double>(players);
+        }
+        for (double& rating : elo) rating += 1500.0 - mean;
+        return elo;
+    }
+
+    double Percent(const std::uint64_t count, const std::uint64_t total) {
+        return total == 0 ? 0.0 : 100.0 * static_cast<double>(count) / static_cast<double>(total);
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) return 2;
+
+    // the game events of every move of every game would swamp the log
+    Logger::GetInstance().SetMinimumLevel(LogLevel::Warn);
+    if (!TextureAtlas::GetInstance().Build(options.resources)) {
+        std::fprintf(stderr, "tournament: could not build the texture atlas from %s\n", options.resources);
+        return 1;
+    }
+
+    const std::size_t          players = options.players.size();
+    std::vector<PairingResult> results(players * players);
+
+    std::mutex              mutex;
+    std::condition_variable done;
+    std::size_t             remaining = 0;
+    std::uint64_t           played    = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool    pool("Tournament", options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                                                              : options.threads);
+        std::uint32_t task_seed = options.seed;
+        for (std::size_t first = 0; first < players; first++) {
+            for (std::size_t second = 0; second < players; second++) {
+                if (first == second) continue;
+                for (int offset = 0; offset < options.games; offset += GAMES_PER_TASK) {
+                    const int games = std::min(GAMES_PER_TASK, options.games - offset);
+                    {
+                        std::lock_guard lock(mutex);
+                        remaining++;
+                    }
+                    pool.Submit([&, first, second, games, seed = task_seed++] {
+                        PairingResult batch;
+                        PlayGames(options.players[first], options.players[second], games, seed, batch);
+
+                        std::lock_guard lock(mutex);
+                        PairingResult& total = results[first * players + second];
+                        total.first_wins += batch.first_wins;
+                        total.draws += batch.draws;
+                        total.second_wins += batch.second_wins;
+                        played += static_cast<std::uint64_t>(games);
+                        if (--remaining == 0) done.notify_one();
+                    });
+                }
+            }
+        }
+
+        std::unique_lock lock(mutex);
+        done.wait(lock, [&] { return remaining == 0; });
+        std::printf("%llu games on %zu threads", static_cast<unsigned long long>(played), pool.ThreadCount());
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf(" in %.2f s, %.0f games/s\n\n", seconds, static_cast<double>(played) / seconds);
+
+    // each player's record over both seats
+    const std::vector<double> elo = FitElo(results, players);
+    std::printf("%-12s %8s %8s %8s %8s\n", "", "win %", "draw %", "loss %", "elo");
+    std::vector<std::size_t> order(players);
+    for (std::size_t i = 0; i < players; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return elo[a] > elo[b]; });
+    for (const std::size_t i : order) {
+        std::uint64_t wins = 0, draws = 0, losses = 0;
+        for (std::size_t j = 0; j < players; j++) {
+            if (i == j) continue;
+            const PairingResult& moving_first  = results[i * players + j];
+            const PairingResult& moving_second = results[j * players + i];
+            wins += moving_first.first_wins + moving_second.second_wins;
+            draws += moving_first.draws + moving_second.draws;
+            losses += moving_first.second_wins + moving_second.first_wins;
+        }
+        const std::uint64_t total = wins + draws + losses;
+        std::printf("%-12s %8.1f %8.1f %8.1f %8.0f\n", options.players[i].name.c_str(), Percent(wins, total),
+                    Percent(draws, total), Percent(losses, total), elo[i]);
+    }
+
+    std::printf("\nfirst vs second: first wins / draws / second wins (%%)\n");
+    for (std::size_t first = 0; first < players; first++) {
+        for (std::size_t second = 0; second < players; second++) {
+            if (first == second) continue;
+            const PairingResult& r     = results[first * players + second];
+            const std::uint64_t  total = r.first_wins + r.draws + r.second_wins;
+            std::printf("  %-10s vs %-10s %5.1f / %5.1f / %5.1f\n", options.players[first].name.c_str(),
+                        options.players[second].name.c_str(), Percent(r.first_wins, total), Percent(r.draws, total),
+                        Percent(r.second_wins, total));
+        }
+    }
+    return 0;
+}
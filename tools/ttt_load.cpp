@@ -0,0 +1,248 @@
+//
+// ttt_load: load generator for ttt_server, reporting the latency of the server's moves (Linux)
+//
+//   ttt_load [--socket path | --tcp port] [--connections N] [--games N] [--seconds S] [--seed N]
+//
+// Every connection runs on its own thread and keeps --games games going at once (so connections * games games are
+// open on the server), playing random legal moves and starting a new game whenever one ends, half of them with the
+// server moving first. A move's latency is the time from sending it to getting the server's answer back, which
+// includes the AI's search. After --seconds no new requests are sent and the replies still due are waited for.
+//
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "classes/MatchProtocol.hpp"
+
+namespace {
+    using namespace MatchProtocol;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        const char*   socket_path = DEFAULT_SOCKET;
+        int           tcp_port    = 0;
+        int           connections = 8;
+        int           games       = 128;
+        double        seconds     = 10.0;
+        std::uint32_t seed        = 1;
+    };
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg   = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (std::strcmp(arg, "--socket") == 0 && value) options.socket_path = argv[++i];
+            else if (std::strcmp(arg, "--tcp") == 0 && value) options.tcp_port = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--connections") == 0 && value) options.connections = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(arg, "--games") == 0 && value) options.games = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(arg, "--seconds") == 0 && value) options.seconds = std::atof(argv[++i]);
+            else if (std::strcmp(arg, "--seed") == 0 && value) options.seed = std::strtoul(argv[++i], nullptr, 10);
+            else {
+                std::fprintf(stderr,
+                             "usage: %s [--socket path | --tcp port] [--connections N] [--games N] [--seconds S] "
+                             "[--seed N]\n",
+                             argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // what one connection saw
+    struct LoadResult {
+        std::vector<double> latencies_us;
+        std::uint64_t       games_finished = 0;
+        std::uint64_t       results[4]     = {}; // by MatchResult
+        std::uint64_t       errors         = 0;
+        bool                connected      = false;
+    };
+
+    int Connect(const Options& options) {
+        if (options.tcp_port > 0) {
+            const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            sockaddr_in address{};
+            address.sin_family      = AF_INET;
+            address.sin_port        = htons(static_cast<std::uint16_t>(options.tcp_port));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                if (fd >= 0) close(fd);
+                return -1;
+            }
+            const int no_delay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+            return fd;
+        }
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, options.socket_path, sizeof(address.sun_path) - 1);
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool SendAll(const int fd, const std::vector<MatchMessage>& messages) {
+        const auto* data = reinterpret_cast<const std::uint8_t*>(messages.data());
+        std::size_t size = messages.size() * sizeof(MatchMessage);
+        while (size > 0) {
+            const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent <= 0) return false;
+            data += sent;
+            size -= static_cast<std::size_t>(sent);
+        }
+        return true;
+    }
+
+    void RunConnection(const Options& options, const int index, const Clock::time_point deadline, LoadResult& result) {
+        const int fd = Connect(options);
+        if (fd < 0) return;
+        result.connected = true;
+
+        struct ClientGame {
+            std::array<std::uint8_t, 9> board{}; // 0 empty, otherwise taken
+            Clock::time_point           move_sent;
+        };
+        std::unordered_map<std::uint32_t, ClientGame> games;
+        std::mt19937                                  random(options.seed + static_cast<std::uint32_t>(index));
+        std::vector<MatchMessage>                     requests;
+        std::size_t                                   waiting  = 0; // requests sent whose reply hasn't come yet
+        bool                                          stopping = false;
+
+        const auto new_game = [&] {
+            requests.push_back({NEW_GAME, static_cast<std::uint8_t>(random() & 1), 0, 0, 0});
+        };
+        const auto move = [&](const std::uint32_t id, ClientGame& game) {
+            std::uint8_t open[9];
+            int          count = 0;
+            for (std::uint8_t cell = 0; cell < 9; cell++) {
+                if (!game.board[cell]) open[count++] = cell;
+            }
+            const std::uint8_t cell = open[std::uniform_int_distribution<int>(0, count - 1)(random)];
+            game.board[cell]        = 1;
+            game.move_sent          = Clock::now();
+            requests.push_back({MOVE, cell, 0, 0, id});
+        };
+
+        for (int i = 0; i < options.games; i++) new_game();
+
+        std::uint8_t buffer[64 * 1024];
+        std::size_t  buffered = 0;
+        while (true) {
+            if (!stopping && Clock::now() >= deadline) stopping = true;
+            if (stopping) requests.clear();
+            if (!requests.empty()) {
+                if (!SendAll(fd, requests)) break;
+                waiting += requests.size();
+                requests.clear();
+            }
+            if (waiting == 0) break;
+
+            const ssize_t received = recv(fd, buffer + buffered, sizeof(buffer) - buffered, 0);
+            if (received < 0 && errno == EINTR) continue;
+            if (received <= 0) break;
+            buffered += static_cast<std::size_t>(received);
+
+            const auto  now    = Clock::now();
+            std::size_t offset = 0;
+            for (; buffered - offset >= sizeof(MatchMessage); offset += sizeof(MatchMessage)) {
+                MatchMessage reply;
+                std::memcpy(&reply, buffer + offset, sizeof(reply));
+                waiting--;
+
+                if (reply.type == ERROR) {
+                    result.errors++;
+                    games.erase(reply.game);
+                    if (reply.cell != SERVER_FULL) new_game();
+                    continue;
+                }
+                if (reply.type == CLOSED) continue;
+
+                ClientGame& game = games[reply.game];
+                if (reply.type == MOVED) {
+                    result.latencies_us.push_back(std::chrono::duration<double, std::micro>(now - game.move_sent).count());
+                }
+                if (reply.cell < 9) game.board[reply.cell] = 2;
+                if (reply.result != PLAYING) {
+                    result.games_finished++;
+                    result.results[reply.result & 3]++;
+                    games.erase(reply.game);
+                    new_game();
+                }
+                else {
+                    move(reply.game, game);
+                }
+            }
+            std::memmove(buffer, buffer + offset, buffered - offset);
+            buffered -= offset;
+        }
+        close(fd);
+    }
+
+    double Percentile(const std::vector<double>& sorted, const double fraction) {
+        if (sorted.empty()) return 0.0;
+        const std::size_t index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) return 2;
+
+    std::vector<LoadResult>  results(static_cast<std::size_t>(options.connections));
+    std::vector<std::thread> threads;
+    const auto               start = Clock::now();
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    for (int i = 0; i < options.connections; i++) {
+        threads.emplace_back(RunConnection, std::cref(options), i, deadline, std::ref(results[i]));
+    }
+    for (std::thread& thread : threads) thread.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    LoadResult total;
+    int        connected = 0;
+    for (const LoadResult& result : results) {
+        connected += result.connected ? 1 : 0;
+        total.latencies_us.insert(total.latencies_us.end(), result.latencies_us.begin(), result.latencies_us.end());
+        total.games_finished += result.games_finished;
+        total.errors += result.errors;
+        for (int i = 0; i < 4; i++) total.results[i] += result.results[i];
+    }
+    if (connected == 0) {
+        std::fprintf(stderr, "ttt_load: could not connect to %s\n", options.tcp_port > 0 ? "the TCP port" : options.socket_path);
+        return 1;
+    }
+    std::sort(total.latencies_us.begin(), total.latencies_us.end());
+
+    std::printf("%d connections, %d games each, %.1f s\n", connected, options.games, seconds);
+    std::printf("moves:    %zu (%.0f/s)\n", total.latencies_us.size(), static_cast<double>(total.latencies_us.size()) / seconds);
+    std::printf("games:    %llu (%.0f/s): client won %llu, server won %llu, drawn %llu\n",
+                static_cast<unsigned long long>(total.games_finished), static_cast<double>(total.games_finished) / seconds,
+                static_cast<unsigned long long>(total.results[CLIENT_WON]),
+                static_cast<unsigned long long>(total.results[SERVER_WON]),
+                static_cast<unsigned long long>(total.results[DRAW]));
+    std::printf("latency:  p50 %.0f us  p99 %.0f us  max %.0f us\n", Percentile(total.latencies_us, 0.5),
+                Percentile(total.latencies_us, 0.99), total.latencies_us.empty() ? 0.0 : total.latencies_us.back());
+    if (total.errors > 0) std::printf("errors:   %llu\n", static_cast<unsigned long long>(total.errors));
+    return 0;
+}
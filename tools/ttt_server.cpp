@@ -0,0 +1,552 @@
+//
+// ttt_server: tic-tac-toe against the AI as a local service, thousands of games at once (Linux)
+//
+//   ttt_server [--socket path | --tcp port] [--threads N] [--depth N] [--blunder P] [--max-games N] [--seed N]
+//              [--resources dir]
+//
+// Clients connect to a Unix socket (MatchProtocol::DEFAULT_SOCKET by default) or to a loopback TCP port and play any
+// number of games per connection with the fixed-size messages of classes/MatchProtocol.hpp. Every game is a headless
+// TicTacToe owned by the event loop thread; only the AI's searches leave it, as state strings searched on a thread
+// pool, whose results come back through an eventfd. Stop it with Ctrl-C (SIGINT) or SIGTERM.
+//
+// Like tournament, it builds the texture atlas (from --resources, resources/ by default) so the games' sprites never
+// need the render thread's texture loader.
+//
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "classes/Logger.hpp"
+#include "classes/MatchProtocol.hpp"
+#include "classes/TextureAtlas.hpp"
+#include "classes/ThreadPool.hpp"
+#include "classes/TicTacToe.h"
+#include "classes/TicTacToeAI.hpp"
+
+namespace {
+    using namespace MatchProtocol;
+
+    // epoll tags below this are the server's own descriptors, connections count up from FIRST_CONNECTION
+    constexpr std::uint64_t LISTENER_TAG     = 1;
+    constexpr std::uint64_t SEARCHES_TAG     = 2;
+    constexpr std::uint64_t SIGNALS_TAG      = 3;
+    constexpr std::uint64_t FIRST_CONNECTION = 16;
+    // no owner: the game's connection went away (or gave it up) while its AI was searching
+    constexpr std::uint64_t NO_CONNECTION = 0;
+
+    constexpr int         MAX_EVENTS = 256;
+    constexpr std::size_t READ_CHUNK = 64 * 1024;
+
+    struct Options {
+        const char*   socket_path = DEFAULT_SOCKET;
+        int           tcp_port    = 0;
+        std::size_t   threads     = 0;
+        std::size_t   max_games   = 100000;
+        std::uint32_t seed        = 1;
+        const char*   resources   = "resources";
+        AIConfig      ai;
+    };
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg   = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (std::strcmp(arg, "--socket") == 0 && value) options.socket_path = argv[++i];
+            else if (std::strcmp(arg, "--tcp") == 0 && value) options.tcp_port = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--threads") == 0 && value) options.threads = std::strtoul(argv[++i], nullptr, 10);
+            else if (std::strcmp(arg, "--depth") == 0 && value) options.ai.depth = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--blunder") == 0 && value) options.ai.blunder = std::clamp(std::atof(argv[++i]), 0.0, 1.0);
+            else if (std::strcmp(arg, "--max-games") == 0 && value) options.max_games = std::strtoul(argv[++i], nullptr, 10);
+            else if (std::strcmp(arg, "--seed") == 0 && value) options.seed = std::strtoul(argv[++i], nullptr, 10);
+            else if (std::strcmp(arg, "--resources") == 0 && value) options.resources = argv[++i];
+            else {
+                std::fprintf(stderr,
+                             "usage: %s [--socket path | --tcp port] [--threads N] [--depth N] [--blunder P] "
+                             "[--max-games N] [--seed N] [--resources dir]\n",
+                             argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct Connection {
+        int                               fd = -1;
+        std::vector<std::uint8_t>         input;  // the start of a message that hasn't fully arrived
+        std::vector<std::uint8_t>         output; // replies the socket hasn't taken yet
+        std::size_t                       output_sent      = 0;
+        bool                              waiting_to_write = false;
+        std::unordered_set<std::uint32_t> games; // the games it's playing
+    };
+
+    struct HostedGame {
+        std::unique_ptr<TicTacToe> game;
+        std::uint64_t              connection    = NO_CONNECTION;
+        int                        client_player = 0;
+        bool                       searching     = false;
+    };
+
+    struct SearchResult {
+        std::uint32_t game;
+        int           square;
+    };
+
+    class MatchServer {
+    public:
+        explicit MatchServer(const Options& options)
+            : options(options), pool(std::make_unique<ThreadPool>("AI", options.threads)) {}
+
+        ~MatchServer() {
+            // running searches still write to searches_ready
+            pool.reset();
+            for (auto& [tag, connection] : connections) close(connection.fd);
+            for (const int fd : {listener, searches_ready, signals, epoll}) {
+                if (fd >= 0) close(fd);
+            }
+            if (options.tcp_port == 0 && listener >= 0) unlink(options.socket_path);
+        }
+
+        bool Start();
+        void Run();
+
+    private:
+        int  Listen();
+        void Watch(int fd, std::uint64_t tag, std::uint32_t events);
+        void Accept();
+        void Read(std::uint64_t tag);
+        void Handle(std::uint64_t tag, Connection& connection, const MatchMessage& request);
+        void StartGame(std::uint64_t tag, Connection& connection, const MatchMessage& request);
+        void PlayMove(std::uint64_t tag, Connection& connection, const MatchMessage& request);
+        void CloseGame(std::uint64_t tag, Connection& connection, const MatchMessage& request);
+        void Search(std::uint32_t id, HostedGame& hosted);
+        void FinishSearches();
+        void EndGame(std::uint32_t id);
+        MatchResult Result(const HostedGame& hosted) const;
+        void Reply(Connection& connection, std::uint8_t type, std::uint32_t game, std::uint8_t cell,
+                   std::uint8_t result = PLAYING);
+        void Flush(std::uint64_t tag);
+        void Drop(std::uint64_t tag);
+
+        const Options options;
+        int           epoll          = -1;
+        int           listener       = -1;
+        int           searches_ready = -1; // eventfd, bumped by the pool for every finished search
+        int           signals        = -1;
+        bool          running        = true;
+
+        std::unordered_map<std::uint64_t, Connection> connections;
+        std::uint64_t                                  next_connection = FIRST_CONNECTION;
+
+        std::unordered_map<std::uint32_t, HostedGame> games;
+        std::uint32_t                                 next_game = 1;
+        // finished games' boards, reused instead of building a new TicTacToe for every game
+        std::vector<std::unique_ptr<TicTacToe>> spare_games;
+
+        std::mutex                search_mutex;
+        std::vector<SearchResult> finished_searches; // guarded by search_mutex
+        std::vector<SearchResult> search_batch;      // loop thread only, swapped with finished_searches
+
+        std::unique_ptr<ThreadPool> pool;
+
+        // stats
+        std::uint64_t games_started = 0;
+        std::uint64_t moves_played  = 0;
+        std::size_t   peak_games    = 0;
+    };
+
+    int MatchServer::Listen() {
+        if (options.tcp_port > 0) {
+            const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) return -1;
+            const int reuse = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            sockaddr_in address{};
+            address.sin_family      = AF_INET;
+            address.sin_port        = htons(static_cast<std::uint16_t>(options.tcp_port));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (std::strlen(options.socket_path) >= sizeof(address.sun_path)) return -1;
+        std::strcpy(address.sun_path, options.socket_path);
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        unlink(options.socket_path); // left behind by a server that didn't shut down
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void MatchServer::Watch(const int fd, const std::uint64_t tag, const std::uint32_t events) {
+        epoll_event event{};
+        event.events   = events;
+        event.data.u64 = tag;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    // SIGINT and SIGTERM arrive through the event loop, so shutting down never interrupts a half-handled request. they
+    // have to be blocked before any thread is started, every thread inherits the mask
+    sigset_t StopSignals() {
+        sigset_t stop_signals;
+        sigemptyset(&stop_signals);
+        sigaddset(&stop_signals, SIGINT);
+        sigaddset(&stop_signals, SIGTERM);
+        return stop_signals;
+    }
+
+    bool MatchServer::Start() {
+        const sigset_t stop_signals = StopSignals();
+        epoll          = epoll_create1(EPOLL_CLOEXEC);
+        searches_ready = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        signals        = signalfd(-1, &stop_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        listener       = Listen();
+        if (epoll < 0 || searches_ready < 0 || signals < 0 || listener < 0) {
+            std::fprintf(stderr, "ttt_server: could not listen on %s: %s\n",
+                         options.tcp_port > 0 ? "the TCP port" : options.socket_path, std::strerror(errno));
+            return false;
+        }
+        Watch(listener, LISTENER_TAG, EPOLLIN);
+        Watch(searches_ready, SEARCHES_TAG, EPOLLIN);
+        Watch(signals, SIGNALS_TAG, EPOLLIN);
+        return true;
+    }
+
+    void MatchServer::Run() {
+        epoll_event events[MAX_EVENTS];
+        while (running) {
+            const int count = epoll_wait(epoll, events, MAX_EVENTS, -1);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                std::perror("ttt_server: epoll_wait");
+                return;
+            }
+            for (int i = 0; i < count; i++) {
+                const std::uint64_t tag   = events[i].data.u64;
+                const std::uint32_t flags = events[i].events;
+                if (tag == LISTENER_TAG) Accept();
+                else if (tag == SEARCHES_TAG) FinishSearches();
+                else if (tag == SIGNALS_TAG) running = false;
+                else if (!connections.count(tag)) continue; // dropped earlier in this batch
+                else if (flags & (EPOLLHUP | EPOLLERR)) Drop(tag);
+                else {
+                    if (flags & EPOLLIN) Read(tag);
+                    if ((flags & EPOLLOUT) && connections.count(tag)) Flush(tag);
+                }
+            }
+        }
+        std::printf("\nttt_server: %llu games, %llu moves, at most %zu games at once\n",
+                    static_cast<unsigned long long>(games_started), static_cast<unsigned long long>(moves_played),
+                    peak_games);
+    }
+
+    void MatchServer::Accept() {
+        while (true) {
+            const int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return; // EAGAIN once every pending connection is taken
+            if (options.tcp_port > 0) {
+                const int no_delay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+            }
+            const std::uint64_t tag = next_connection++;
+            connections[tag].fd     = fd;
+            Watch(fd, tag, EPOLLIN | EPOLLRDHUP);
+        }
+    }
+
+    void MatchServer::Read(const std::uint64_t tag) {
+        Connection&  connection = connections[tag];
+        std::uint8_t buffer[READ_CHUNK];
+        while (true) {
+            const ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                Drop(tag);
+                return;
+            }
+            if (received < 0) break;
+
+            // whole messages straight from the buffer, only a split one is kept for the next read
+            const std::uint8_t* data = buffer;
+            std::size_t         size = static_cast<std::size_t>(received);
+            MatchMessage        request;
+            if (!connection.input.empty()) {
+                const std::size_t missing = std::min(sizeof(MatchMessage) - connection.input.size(), size);
+                connection.input.insert(connection.input.end(), data, data + missing);
+                data += missing;
+                size -= missing;
+                if (connection.input.size() < sizeof(MatchMessage)) continue;
+                std::memcpy(&request, connection.input.data(), sizeof(request));
+                connection.input.clear();
+                Handle(tag, connection, request);
+            }
+            for (; size >= sizeof(MatchMessage); data += sizeof(MatchMessage), size -= sizeof(MatchMessage)) {
+                std::memcpy(&request, data, sizeof(request));
+                Handle(tag, connection, request);
+            }
+            connection.input.assign(data, data + size);
+        }
+        Flush(tag);
+    }
+
+    void MatchServer::Handle(const std::uint64_t tag, Connection& connection, const MatchMessage& request) {
+        switch (request.type) {
+        case NEW_GAME: StartGame(tag, connection, request); break;
+        case MOVE: PlayMove(tag, connection, request); break;
+        case CLOSE: CloseGame(tag, connection, request); break;
+        default: Reply(connection, ERROR, request.game, BAD_REQUEST); break;
+        }
+    }
+
+    void MatchServer::StartGame(const std::uint64_t tag, Connection& connection, const MatchMessage& request) {
+        if (request.cell > 1) {
+            Reply(connection, ERROR, 0, BAD_REQUEST);
+            return;
+        }
+        if (games.size() >= options.max_games) {
+            Reply(connection, ERROR, 0, SERVER_FULL);
+            return;
+        }
+
+        const std::uint32_t id     = next_game++;
+        HostedGame&         hosted = games[id];
+        if (!spare_games.empty()) {
+            hosted.game = std::move(spare_games.back());
+            spare_games.pop_back();
+        }
+        else {
+            hosted.game = std::make_unique<TicTacToe>();
+            hosted.game->setAIEnabled(false); // the AI's moves are searched and played from here
+        }
+        hosted.game->setUpBoard();
+        hosted.connection    = tag;
+        hosted.client_player = request.cell;
+        connection.games.insert(id);
+        games_started++;
+        peak_games = std::max(peak_games, games.size());
+
+        if (hosted.client_player == 0) Reply(connection, STARTED, id, NO_CELL);
+        else Search(id, hosted); // STARTED goes out with the AI's opening move
+    }
+
+    void MatchServer::PlayMove(const std::uint64_t tag, Connection& connection, const MatchMessage& request) {
+        const auto found = games.find(request.game);
+        if (found == games.end() || found->second.connection != tag) {
+            Reply(connection, ERROR, request.game, NO_SUCH_GAME);
+            return;
+        }
+        HostedGame& hosted = found->second;
+        TicTacToe&  game   = *hosted.game;
+        if (hosted.searching || game.getCurrentPlayer()->playerNumber() != hosted.client_player) {
+            Reply(connection, ERROR, request.game, NOT_YOUR_TURN);
+            return;
+        }
+        if (request.cell >= 9) {
+            Reply(connection, ERROR, request.game, ILLEGAL_MOVE);
+            return;
+        }
+        BitHolder& holder = game.getHolderAt(request.cell % 3, request.cell / 3);
+        if (!game.actionForEmptyHolder(&holder)) {
+            Reply(connection, ERROR, request.game, ILLEGAL_MOVE);
+            return;
+        }
+        game.endTurn(&holder);
+        moves_played++;
+
+        if (game.gameOver()) {
+            Reply(connection, MOVED, request.game, NO_CELL, Result(hosted));
+            connection.games.erase(request.game);
+            EndGame(request.game);
+            return;
+        }
+        Search(request.game, hosted);
+    }
+
+    void MatchServer::CloseGame(const std::uint64_t tag, Connection& connection, const MatchMessage& request) {
+        const auto found = games.find(request.game);
+        if (found == games.end() || found->second.connection != tag) {
+            Reply(connection, ERROR, request.game, NO_SUCH_GAME);
+            return;
+        }
+        Reply(connection, CLOSED, request.game, NO_CELL);
+        connection.games.erase(request.game);
+        if (found->second.searching) found->second.connection = NO_CONNECTION; // ended when the search comes back
+        else EndGame(request.game);
+    }
+
+    void MatchServer::Search(const std::uint32_t id, HostedGame& hosted) {
+        hosted.searching          = true;
+        const std::string   state = hosted.game->stateString();
+        const char          piece = static_cast<char>('1' + hosted.game->getCurrentPlayer()->playerNumber());
+        const std::uint32_t seed  = options.seed ^ (id * 2654435761u) ^ hosted.game->getCurrentTurnNo();
+        pool->Submit([this, id, state, piece, seed] {
+            std::mt19937 random(seed);
+            const int    square = TicTacToeAI::ChooseMove(state, piece, options.ai, random);
+            {
+                std::lock_guard lock(search_mutex);
+                finished_searches.push_back({id, square});
+            }
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const ssize_t written = write(searches_ready, &one, sizeof(one));
+        });
+    }
+
+    void MatchServer::FinishSearches() {
+        std::uint64_t count;
+        [[maybe_unused]] const ssize_t drained = read(searches_ready, &count, sizeof(count));
+        {
+            std::lock_guard lock(search_mutex);
+            search_batch.swap(finished_searches);
+        }
+
+        // the replies of the whole batch go out with one write per connection
+        std::unordered_set<std::uint64_t> replied;
+        for (const SearchResult& search : search_batch) {
+            const auto found = games.find(search.game);
+            if (found == games.end()) continue;
+            HostedGame& hosted = found->second;
+            hosted.searching   = false;
+            if (hosted.connection == NO_CONNECTION) {
+                EndGame(search.game);
+                continue;
+            }
+
+            TicTacToe& game   = *hosted.game;
+            BitHolder& holder = game.getHolderAt(search.square % 3, search.square / 3);
+            game.actionForEmptyHolder(&holder);
+            game.endTurn(&holder);
+            moves_played++;
+
+            Connection&        connection = connections[hosted.connection];
+            const std::uint8_t type       = game.getCurrentTurnNo() == 1 && hosted.client_player == 1 ? STARTED : MOVED;
+            const MatchResult  result     = Result(hosted);
+            Reply(connection, type, search.game, static_cast<std::uint8_t>(search.square), result);
+            replied.insert(hosted.connection);
+            if (result != PLAYING) {
+                connection.games.erase(search.game);
+                EndGame(search.game);
+            }
+        }
+        search_batch.clear();
+        for (const std::uint64_t tag : replied) {
+            if (connections.count(tag)) Flush(tag);
+        }
+    }
+
+    void MatchServer::EndGame(const std::uint32_t id) {
+        const auto found = games.find(id);
+        found->second.game->stopGame();
+        spare_games.push_back(std::move(found->second.game));
+        games.erase(found);
+    }
+
+    MatchResult MatchServer::Result(const HostedGame& hosted) const {
+        const TicTacToe& game = *hosted.game;
+        if (game.isDraw()) return DRAW;
+        if (!game.winner()) return PLAYING;
+        return game.winner()->playerNumber() == hosted.client_player ? CLIENT_WON : SERVER_WON;
+    }
+
+    void MatchServer::Reply(Connection& connection, const std::uint8_t type, const std::uint32_t game,
+                            const std::uint8_t cell, const std::uint8_t result) {
+        const MatchMessage reply{type, cell, result, 0, game};
+        const auto*        bytes = reinterpret_cast<const std::uint8_t*>(&reply);
+        connection.output.insert(connection.output.end(), bytes, bytes + sizeof(reply));
+    }
+
+    void MatchServer::Flush(const std::uint64_t tag) {
+        Connection& connection = connections[tag];
+        while (connection.output_sent < connection.output.size()) {
+            const ssize_t sent = send(connection.fd, connection.output.data() + connection.output_sent,
+                                      connection.output.size() - connection.output_sent, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    Drop(tag);
+                    return;
+                }
+                break;
+            }
+            connection.output_sent += static_cast<std::size_t>(sent);
+        }
+
+        const bool pending = connection.output_sent < connection.output.size();
+        if (!pending) {
+            connection.output.clear();
+            connection.output_sent = 0;
+        }
+        // only asked to be told the socket is writable while there's something to write
+        if (pending != connection.waiting_to_write) {
+            epoll_event event{};
+            event.events   = EPOLLIN | EPOLLRDHUP | (pending ? EPOLLOUT : 0u);
+            event.data.u64 = tag;
+            epoll_ctl(epoll, EPOLL_CTL_MOD, connection.fd, &event);
+            connection.waiting_to_write = pending;
+        }
+    }
+
+    void MatchServer::Drop(const std::uint64_t tag) {
+        const auto found = connections.find(tag);
+        if (found == connections.end()) return;
+        for (const std::uint32_t id : found->second.games) {
+            HostedGame& hosted = games[id];
+            if (hosted.searching) hosted.connection = NO_CONNECTION;
+            else EndGame(id);
+        }
+        epoll_ctl(epoll, EPOLL_CTL_DEL, found->second.fd, nullptr);
+        close(found->second.fd);
+        connections.erase(found);
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) return 2;
+
+    const sigset_t stop_signals = StopSignals();
+    pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    // the game events of every move of every game would swamp the log
+    Logger::GetInstance().SetMinimumLevel(LogLevel::Warn);
+    if (!TextureAtlas::GetInstance().Build(options.resources)) {
+        std::fprintf(stderr, "ttt_server: could not build the texture atlas from %s\n", options.resources);
+        return 1;
+    }
+
+    MatchServer server(options);
+    if (!server.Start()) return 1;
+    if (options.tcp_port > 0) std::printf("ttt_server: listening on 127.0.0.1:%d\n", options.tcp_port);
+    else std::printf("ttt_server: listening on %s\n", options.socket_path);
+    std::fflush(stdout);
+    server.Run();
+    return 0;
+}